@@ -1,6 +1,8 @@
 #include <CRMC.h>
 #include <CRMCinterface.h>
 #include <CRMCoptions.h>
+#include <CRMCprefetch.h>
+#include <CRMCprofiler.h>
 #include <OutputPolicyNone.h>
 
 #include <iomanip>
@@ -24,7 +26,7 @@ using namespace std;
 
 CRMC::CRMC(const CRMCoptions& cfg,
 	   OutputPolicyNone& output)
-  : fCfg(cfg), fOutput(output) {
+  : fCfg(cfg), fOutput(output), fNProfiledTables(0) {
 }
 
 
@@ -33,11 +35,36 @@ bool
 CRMC::init()
 {
   setbuf(stdout, 0); // set output to unbuffered
+  CRMCprofiler& profiler = CRMCprofiler::Get();
   
+  if (fCfg.IsPileup()) {
+    profiler.Phase("pileup bank");
+    fPileup.reset(new CRMCpileup(fCfg));
+  }
+
+  // stored events do not need the model
+  if (fCfg.IsReplay()) {
+    profiler.Phase("replay file");
+    fReplay.reset(CRMCreplay::Create(fCfg.GetReplayFileName()));
+    if (!fReplay) {
+      cerr << " Cannot replay " << fCfg.GetReplayFileName()
+           << " (unknown format or not supported by this build)" << endl;
+      return false;
+    }
+    CRMCprefetch::Get().Stop();
+    profiler.Phase("output (InitOutput)");
+    fOutput.InitOutput(fCfg);
+    profiler.Phase("first event");
+    return true;
+  }
 
+
+  profiler.Phase("model library (CRMCinterface::init)");
   if (fInterface.init(fCfg.GetHEModel()) != 1)
     return false;
   
+  profiler.Phase("crmc_init (parameters, tables, model)");
+  
   // open FORTRAN IO at first call
   //call here variable settings from c++ interface
   fInterface.crmc_init(fCfg.GetSqrts(),
@@ -49,6 +76,7 @@ CRMC::init()
                        fCfg.GetOutputFileName().c_str(),
                        fCfg.GetOutputFileName().size());
   //init models with set variables
+  ProfileTables();
 
   TString runType = fCfg.GetRHICfRunType();
   runType.ToUpper();
@@ -56,13 +84,18 @@ CRMC::init()
   int CollisionEventNum = INT_MAX;
   if(runType != "ALL"){CollisionEventNum = INT_MAX;}
 
+  profiler.Phase("crmc_set (beams, energy)");
   fInterface.crmc_set(CollisionEventNum,
                       fCfg.GetProjectileMomentum(),
                       fCfg.GetTargetMomentum(),
                       fCfg.GetProjectileId(),
                       fCfg.GetTargetId());
+  ProfileTables();
+  CRMCprefetch::Get().Stop();
 
+  profiler.Phase("output (InitOutput)");
   fOutput.InitOutput(fCfg);
+  profiler.Phase("first event");
   //fFilter.Init(fCfg.GetFilter());
   return true;
 }
@@ -80,53 +113,39 @@ CRMC::run()
   int passEventNum = 0;
   int iColl = 0;
 
-  while(1){
-    // cleanup vectors
-    gCRMC_data.Clean();
-
-    if ((iColl+1) % 1000 == 0 || (fCfg.GetProjectileId()+fCfg.GetTargetId()>400 && (iColl+1) %10== 0))
-      cout << " ==[crmc]==> Collision number " << iColl+1 << endl;
-
-    // loop over collisions
-    fInterface.crmc_generate(fCfg.GetTypout(),iColl+1,
-                             gCRMC_data.fNParticles,
-                             gCRMC_data.fImpactParameter,
-                             gCRMC_data.fPartId[0],
-                             gCRMC_data.fPartPx[0],
-                             gCRMC_data.fPartPy[0],
-                             gCRMC_data.fPartPz[0],
-                             gCRMC_data.fPartEnergy[0],
-                             gCRMC_data.fPartMass[0],
-                             gCRMC_data.fPartStatus[0]);
-    
-    gCRMC_data.sigtot = double(hadr5_.sigtot);
-    gCRMC_data.sigine = double(hadr5_.sigine);
-    gCRMC_data.sigela = double(hadr5_.sigela);
-    gCRMC_data.sigdd = double(hadr5_.sigdd);
-    gCRMC_data.sigsd = double(hadr5_.sigsd);
-    gCRMC_data.sloela = double(hadr5_.sloela);
-    gCRMC_data.sigtotaa = double(hadr5_.sigtotaa);
-    gCRMC_data.sigineaa = double(hadr5_.sigineaa);
-    gCRMC_data.sigelaaa = double(hadr5_.sigelaaa);
-    gCRMC_data.npjevt = cevt_.npjevt;
-    gCRMC_data.ntgevt = cevt_.ntgevt;
-    gCRMC_data.kolevt = cevt_.kolevt;
-    gCRMC_data.kohevt = cevt_.kohevt;
-    gCRMC_data.npnevt = cevt_.npnevt;
-    gCRMC_data.ntnevt = cevt_.ntnevt;
-    gCRMC_data.nppevt = cevt_.nppevt;
-    gCRMC_data.ntpevt = cevt_.ntpevt;
-    gCRMC_data.nglevt = cevt_.nglevt;
-    gCRMC_data.ng1evt = c2evt_.ng1evt;
-    gCRMC_data.ng2evt = c2evt_.ng2evt;
-    gCRMC_data.bimevt = double(cevt_.bimevt);
-    gCRMC_data.phievt = double(cevt_.phievt);
-    gCRMC_data.fglevt = double(c2evt_.fglevt);
-    gCRMC_data.typevt = int(c2evt_.typevt);
-
-    fOutput.FillRHICfEvent(fCfg, iColl, passEventNum);
-    iColl++;
-    if(eventNum == passEventNum){break;}
+  if (fReplay) {
+    while (eventNum != passEventNum && fReplay->Next()) {
+      if (fPileup) fPileup->Mix();
+      fOutput.FillRHICfEvent(fCfg, iColl, passEventNum);
+      if (iColl == 0) EndStartupProfile();
+      iColl++;
+    }
+  }
+  else if (fCfg.IsRegenerate()) {
+    // only the listed collisions, each one from its own seed
+    for (const auto& event : fCfg.GetRegenerateEvents()) {
+      gCRMC_data.fEventSeed = event.fSeed;
+      generate(event.fCollision);
+      fOutput.FillRHICfEvent(fCfg, event.fCollision, passEventNum);
+      if (iColl == 0) EndStartupProfile();
+      iColl++;
+    }
+  }
+  else {
+    while(1){
+      if ((iColl+1) % 1000 == 0 || (fCfg.GetProjectileId()+fCfg.GetTargetId()>400 && (iColl+1) %10== 0))
+        cout << " ==[crmc]==> Collision number " << iColl+1 << endl;
+
+      if (fCfg.UseEventSeeds())
+        gCRMC_data.fEventSeed = fCfg.GetEventSeed(iColl);
+      generate(iColl);
+      if (fPileup) fPileup->Mix();
+
+      fOutput.FillRHICfEvent(fCfg, iColl, passEventNum);
+      if (iColl == 0) EndStartupProfile();
+      iColl++;
+      if(eventNum == passEventNum){break;}
+    }
   }
 
   std::cout.precision(2);
@@ -148,6 +167,94 @@ CRMC::run()
 
 
 
+void
+CRMC::ProfileTables()
+{
+  if (!fInterface.crmc_tables)
+    return;
+  char name[1024];
+  double seconds = 0;
+  double peakRSS = 0;
+  int fromCache = 0;
+  while (fInterface.crmc_tables(fNProfiledTables, name, sizeof(name), seconds, peakRSS, fromCache)) {
+    CRMCprofiler::Get().AddTable(name, seconds, peakRSS, fromCache);
+    fNProfiledTables++;
+  }
+}
+
+
+
+void
+CRMC::EndStartupProfile()
+{
+  CRMCprofiler& profiler = CRMCprofiler::Get();
+  ProfileTables(); // e.g. read at the first event
+  profiler.Stop();
+  if (!fCfg.IsProfileStartup())
+    return;
+
+  profiler.Print(cout);
+  const string& jsonName = fCfg.GetProfileStartupName();
+  if (jsonName != "-" && !profiler.WriteJSON(jsonName))
+    cerr << " Cannot write the start-up profile to " << jsonName << endl;
+}
+
+
+
+void
+CRMC::generate(const int iColl)
+{
+  // cleanup vectors
+  gCRMC_data.Clean();
+
+  // the collision does not depend on the ones generated before
+  if (gCRMC_data.fEventSeed > 0)
+    fInterface.crmc_reseed(gCRMC_data.fEventSeed);
+
+  fInterface.crmc_generate(fCfg.GetTypout(),iColl+1,
+                           gCRMC_data.fNParticles,
+                           gCRMC_data.fImpactParameter,
+                           gCRMC_data.fPartId[0],
+                           gCRMC_data.fPartPx[0],
+                           gCRMC_data.fPartPy[0],
+                           gCRMC_data.fPartPz[0],
+                           gCRMC_data.fPartEnergy[0],
+                           gCRMC_data.fPartMass[0],
+                           gCRMC_data.fPartStatus[0]);
+  
+  // sinks of another output type get the event stored again, not
+  // possible once pileup is mixed in
+  gCRMC_data.fTypout = fCfg.GetTypout();
+  gCRMC_data.fStore = (fPileup ? 0 : fInterface.crmc_store);
+
+  gCRMC_data.sigtot = double(hadr5_.sigtot);
+  gCRMC_data.sigine = double(hadr5_.sigine);
+  gCRMC_data.sigela = double(hadr5_.sigela);
+  gCRMC_data.sigdd = double(hadr5_.sigdd);
+  gCRMC_data.sigsd = double(hadr5_.sigsd);
+  gCRMC_data.sloela = double(hadr5_.sloela);
+  gCRMC_data.sigtotaa = double(hadr5_.sigtotaa);
+  gCRMC_data.sigineaa = double(hadr5_.sigineaa);
+  gCRMC_data.sigelaaa = double(hadr5_.sigelaaa);
+  gCRMC_data.npjevt = cevt_.npjevt;
+  gCRMC_data.ntgevt = cevt_.ntgevt;
+  gCRMC_data.kolevt = cevt_.kolevt;
+  gCRMC_data.kohevt = cevt_.kohevt;
+  gCRMC_data.npnevt = cevt_.npnevt;
+  gCRMC_data.ntnevt = cevt_.ntnevt;
+  gCRMC_data.nppevt = cevt_.nppevt;
+  gCRMC_data.ntpevt = cevt_.ntpevt;
+  gCRMC_data.nglevt = cevt_.nglevt;
+  gCRMC_data.ng1evt = c2evt_.ng1evt;
+  gCRMC_data.ng2evt = c2evt_.ng2evt;
+  gCRMC_data.bimevt = double(cevt_.bimevt);
+  gCRMC_data.phievt = double(cevt_.phievt);
+  gCRMC_data.fglevt = double(c2evt_.fglevt);
+  gCRMC_data.typevt = int(c2evt_.typevt);
+}
+
+
+
 bool
 CRMC::finish()
 {
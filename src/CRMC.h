@@ -2,6 +2,10 @@
 #define __CRMC_H
 #include <OutputPolicyNone.h>
 #include <CRMCinterface.h>
+#include <CRMCreplay.h>
+#include <CRMCpileup.h>
+
+#include <memory>
 //#include <CRMCfilter.h>
 
 // //////////
@@ -21,10 +25,19 @@ class CRMC {
   CRMCinterface& GetInterface() { return fInterface; }
 
  private:
+  /** Generate collision iColl into gCRMC_data */
+  void generate(const int iColl);
+  /** Tables read by the model since the last call, for --profile-startup */
+  void ProfileTables();
+  /** The start-up is over with the first event */
+  void EndStartupProfile();
 
   const CRMCoptions& fCfg;
   CRMCinterface fInterface;
   OutputPolicyNone& fOutput;
+  std::unique_ptr<CRMCreplay> fReplay; // --replay, instead of the model
+  std::unique_ptr<CRMCpileup> fPileup; // --pileup-bank
+  int fNProfiledTables;
   //CRMCfilter fFilter;
 
 };
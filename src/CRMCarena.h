@@ -0,0 +1,173 @@
+// -*- mode: C++ -*-
+/**
+ * @file      src/CRMCarena.h
+ *
+ * @brief  Memory arena for the std::shared_ptr particles and vertices
+ *         created by CRMChepevt
+ */
+#ifndef CRMCarena_h
+#define CRMCarena_h
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Hands out memory in a few size classes from large chunks and keeps
+ * freed blocks on a free list per size class.  Once the largest event
+ * has been seen no more memory is requested from the system.
+ *
+ * Only the thread filling the events allocates, and it also gives most
+ * blocks back, so its free lists take no lock.  Blocks released by
+ * another thread (e.g. when the event is written or analysed
+ * asynchronously) go to a lock-free list per size class, which the
+ * filling thread takes over as a whole when its own list is empty.
+ *
+ * @ingroup utils
+ */
+class CRMCarena
+{
+public:
+  CRMCarena() : _left(0), _next(0)
+  {
+    for (std::size_t i = 0; i < nClasses; ++i) {
+      _free[i] = 0;
+      _remote[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void* allocate(std::size_t bytes)
+  {
+    const std::size_t cls = sizeClass(bytes);
+    if (cls >= nClasses) return ::operator new(bytes);
+
+    if (_chunks.empty()) _owner = std::this_thread::get_id(); // first allocation
+    if (!_free[cls]) _free[cls] = _remote[cls].exchange(0, std::memory_order_acquire);
+    if (_free[cls]) {
+      FreeBlock* b = _free[cls];
+      _free[cls] = b->next;
+      return b;
+    }
+    const std::size_t size = (cls + 1) * align;
+    if (_left < size) {
+      _chunks.emplace_back(new Block[chunkSize / align]);
+      _next = reinterpret_cast<char*>(_chunks.back().get());
+      _left = chunkSize;
+    }
+    void* p = _next;
+    _next += size;
+    _left -= size;
+    return p;
+  }
+
+  void deallocate(void* p, std::size_t bytes)
+  {
+    const std::size_t cls = sizeClass(bytes);
+    if (cls >= nClasses) { ::operator delete(p); return; }
+
+    FreeBlock* b = static_cast<FreeBlock*>(p);
+    if (std::this_thread::get_id() == _owner) {
+      b->next = _free[cls];
+      _free[cls] = b;
+      return;
+    }
+    b->next = _remote[cls].load(std::memory_order_relaxed);
+    while (!_remote[cls].compare_exchange_weak(b->next, b, std::memory_order_release,
+                                               std::memory_order_relaxed))
+      ;
+  }
+
+private:
+  CRMCarena(const CRMCarena&);
+  CRMCarena& operator=(const CRMCarena&);
+
+  struct FreeBlock { FreeBlock* next; };
+  using Block = std::aligned_storage<16, 16>::type;
+
+  /** Granularity and alignment of the blocks */
+  static const std::size_t align = sizeof(Block);
+  /** Blocks up to nClasses*align bytes come from the arena */
+  static const std::size_t nClasses = 32;
+  static const std::size_t chunkSize = 64 * 1024;
+
+  static std::size_t sizeClass(std::size_t bytes)
+  {
+    return bytes == 0 ? 0 : (bytes - 1) / align;
+  }
+
+  std::thread::id _owner; // the thread filling the events
+  std::vector<std::unique_ptr<Block[]>> _chunks;
+  FreeBlock* _free[nClasses];
+  std::atomic<FreeBlock*> _remote[nClasses]; // released by other threads
+  std::size_t _left;
+  char* _next;
+};
+
+/**
+ * Allocator for std::allocate_shared using a CRMCarena.  Copies share
+ * the arena, so it lives as long as the last object allocated from it.
+ */
+template <typename T>
+struct CRMCarenaAllocator
+{
+  using value_type = T;
+
+  explicit CRMCarenaAllocator(const std::shared_ptr<CRMCarena>& arena)
+    : _arena(arena) {}
+  template <typename U>
+  CRMCarenaAllocator(const CRMCarenaAllocator<U>& o) : _arena(o._arena) {}
+
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+  }
+  void deallocate(T* p, std::size_t n) { _arena->deallocate(p, n * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const CRMCarenaAllocator<U>& o) const { return _arena == o._arena; }
+  template <typename U>
+  bool operator!=(const CRMCarenaAllocator<U>& o) const { return _arena != o._arena; }
+
+  std::shared_ptr<CRMCarena> _arena;
+};
+
+/**
+ * Factory for CRMChepevt (see CRMCmakeFactory) creating the
+ * std::shared_ptr particles and vertices (HepMC3) in an arena, so that
+ * filling an event does not go to the heap for every entry.
+ *
+ * @ingroup model
+ */
+template <typename Particle,
+	  typename Vertex,
+	  typename Vector>
+struct CRMCarenaFactory
+{
+  using ParticleType=typename Particle::element_type;
+  using VertexType=typename Vertex::element_type;
+
+  CRMCarenaFactory() : _arena(std::make_shared<CRMCarena>()) {}
+
+  /** Nothing to do, the objects of the last event return to the arena when released */
+  void reset() {}
+  /** Create a vertex at pos */
+  Vertex vertex(const Vector& pos)
+  {
+    return std::allocate_shared<VertexType>(CRMCarenaAllocator<VertexType>(_arena), pos);
+  }
+  /** Create a particle */
+  Particle particle(const Vector& mom, int pdg, int sts)
+  {
+    return std::allocate_shared<ParticleType>(CRMCarenaAllocator<ParticleType>(_arena),
+					      mom, pdg, sts);
+  }
+protected:
+  std::shared_ptr<CRMCarena> _arena;
+};
+#endif
+//
+// EOF
+//
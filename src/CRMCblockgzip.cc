@@ -0,0 +1,119 @@
+#include <CRMCblockgzip.h>
+
+#include <cstring>
+#include <iostream>
+
+#include <zlib.h>
+
+using namespace std;
+
+
+CRMCblockGzip::BlockBuffer::BlockBuffer()
+  : fData(1 << 20)
+{
+  Clear();
+}
+
+
+CRMCblockGzip::BlockBuffer::int_type
+CRMCblockGzip::BlockBuffer::overflow(int_type c)
+{
+  // grow the block, it holds all events until the next StartBlock
+  const size_t size = Size();
+  fData.resize(2 * fData.size());
+  setp(&fData[0], &fData[0] + fData.size());
+  pbump(int(size));
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+
+CRMCblockGzip::CRMCblockGzip(const string& fileName, const int level)
+  : ostream(0),
+    fFile(0),
+    fIndex(0),
+    fLevel(level),
+    fFailed(false),
+    fStarted(false),
+    fCompressedOffset(0),
+    fUncompressedOffset(0)
+{
+  rdbuf(&fBuffer);
+  fFile = fopen(fileName.c_str(), "wb");
+  fIndex = fopen((fileName + ".idx").c_str(), "w");
+  if (!fFile || !fIndex) {
+    cerr << " Cannot open block compressed output " << fileName << endl;
+    fFailed = true;
+    setstate(ios_base::badbit);
+    return;
+  }
+  fprintf(fIndex, "# first-event compressed-offset uncompressed-offset\n");
+}
+
+
+CRMCblockGzip::~CRMCblockGzip()
+{
+  Close();
+}
+
+
+void
+CRMCblockGzip::StartBlock(const int nEvent)
+{
+  if (!fFile)
+    return;
+  // the listing header written before the first event stays in its block
+  if (fStarted && fBuffer.Size() > 0)
+    WriteBlock();
+  fStarted = true;
+  fprintf(fIndex, "%d %llu %llu\n", nEvent, fCompressedOffset, fUncompressedOffset);
+}
+
+
+void
+CRMCblockGzip::Close()
+{
+  if (!fFile)
+    return;
+  if (fBuffer.Size() > 0)
+    WriteBlock();
+  fclose(fFile);
+  fclose(fIndex);
+  fFile = 0;
+  fIndex = 0;
+}
+
+
+void
+CRMCblockGzip::WriteBlock()
+{
+  // one complete gzip member (windowBits 15 + 16) per block
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if (deflateInit2(&zs, fLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    fFailed = true;
+    setstate(ios_base::badbit);
+    return;
+  }
+  const size_t size = fBuffer.Size();
+  fCompressed.resize(deflateBound(&zs, size));
+  zs.next_in = (Bytef*)fBuffer.Data();
+  zs.avail_in = size;
+  zs.next_out = &fCompressed[0];
+  zs.avail_out = fCompressed.size();
+  const int ret = deflate(&zs, Z_FINISH);
+  const size_t compressed = fCompressed.size() - zs.avail_out;
+  deflateEnd(&zs);
+
+  if (ret != Z_STREAM_END || fwrite(&fCompressed[0], 1, compressed, fFile) != compressed) {
+    cerr << " Error writing block compressed output" << endl;
+    fFailed = true;
+    setstate(ios_base::badbit);
+  }
+  fCompressedOffset += compressed;
+  fUncompressedOffset += size;
+  fBuffer.Clear();
+}
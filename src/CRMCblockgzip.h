@@ -0,0 +1,64 @@
+#ifndef _CRMCblockgzip_h_
+#define _CRMCblockgzip_h_
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * Output stream writing a gzip file in independent blocks, in the
+ * spirit of BGZF: every block is a complete gzip member, so the file
+ * is still read by gunzip or any gzip stream, but a reader can also
+ * start decompressing at the beginning of any block.
+ *
+ * Next to the file an index <file>.idx is written with one line per
+ * block:
+ *
+ *   <first event number> <compressed offset> <uncompressed offset>
+ *
+ * The first block starts at offset 0 with the listing header of the
+ * event format, which a reader of a later block has to take from there.
+ */
+class CRMCblockGzip : public std::ostream {
+
+ public:
+  CRMCblockGzip(const std::string& fileName, const int level = 9);
+  ~CRMCblockGzip() override;
+
+  /** Close the current block (if not empty) and open one starting with event nEvent */
+  void StartBlock(const int nEvent);
+  /** Write the last block and close file and index */
+  void Close();
+  bool Failed() const { return fFailed; }
+
+ private:
+  /** Collects the uncompressed data of the current block */
+  class BlockBuffer : public std::streambuf {
+   public:
+    BlockBuffer();
+    const char* Data() const { return pbase(); }
+    size_t Size() const { return pptr() - pbase(); }
+    void Clear() { setp(&fData[0], &fData[0] + fData.size()); }
+   protected:
+    int_type overflow(int_type c) override;
+   private:
+    std::vector<char> fData;
+  };
+
+  void WriteBlock();
+
+  BlockBuffer fBuffer;
+  std::vector<unsigned char> fCompressed;
+  FILE* fFile;
+  FILE* fIndex;
+  int fLevel;
+  bool fFailed;
+  bool fStarted; // StartBlock was called, the header is in the first block
+  unsigned long long fCompressedOffset;
+  unsigned long long fUncompressedOffset;
+};
+
+
+#endif
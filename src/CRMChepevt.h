@@ -12,6 +12,7 @@
 #include <memory>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 #include "CRMCconfig.h"
 #ifndef HepMC_HEPEVT_SIZE
 #error HepMC_HEPEVT_SIZE is not defined!
@@ -207,6 +208,29 @@ namespace {
   }
 }
 
+/** 
+ * Default way for CRMChepevt to create particles and vertices: a new
+ * object (bare pointer or shared_ptr) for each of them.
+ *
+ * Other factories (e.g. recycling the objects of the previous event)
+ * must provide the same three member functions.
+ */
+template <typename Particle,
+	  typename Vertex,
+	  typename Vector>
+struct CRMCmakeFactory
+{
+  /** Called before the conversion of every event */
+  void reset() {}
+  /** Create a vertex at pos */
+  Vertex vertex(const Vector& pos) { return make<Vertex>(pos); }
+  /** Create a particle */
+  Particle particle(const Vector& mom, int pdg, int sts)
+  {
+    return make<Particle>(mom,pdg,sts);
+  }
+};
+
 /** 
  * Converts particles from HEPEVT Fortran common block to
  * HepMC3::GenParticle's and HepMC3::GenVertex's.
@@ -221,13 +245,15 @@ namespace {
 template<typename Particle,
 	 typename Vertex,
 	 typename Vector,
-	 typename EventType>
+	 typename EventType,
+	 typename FactoryType=CRMCmakeFactory<Particle,Vertex,Vector>>
 struct CRMChepevt
 {
   using ParticlePtr=Particle;
   using VertexPtr=Vertex;
   using Event=EventType;
   using FourVector=Vector;
+  using Factory=FactoryType;
   using ParticleVector=std::vector<ParticlePtr>;
   using VertexVector=std::vector<VertexPtr>;
   using Boost=Booster<Vector>;
@@ -265,10 +291,11 @@ struct CRMChepevt
    */
   bool convert()
   {
+    _factory.reset();
     _offshell = 0;
     _beams.clear();
-    _particles.clear();
-    _particles.resize(hepevt_.nhep);
+    _particles.assign(hepevt_.nhep, ParticlePtr());
+    _state.assign(hepevt_.nhep, kNew);
     _vertices.clear();
     for (int i = 0; i < hepevt_.nhep; i++) 
       genParticle(i);
@@ -304,6 +331,8 @@ struct CRMChepevt
   const VertexVector& vertices() const { return _vertices; }
   /** Number of particles that were off-shell */
   int offshell() const { return _offshell; }
+  /** Factory creating the particles and vertices */
+  Factory& factory() { return _factory; }
   /** Dump content of HEPEVT to stream */
   void dump(std::ostream& out=std::cout) const 
   {
@@ -350,13 +379,13 @@ protected:
    *
    * @return end-point vertex of current particle 
    */
-  VertexPtr getVertex(int i) const
+  VertexPtr getVertex(int i)
   {
     HepEvtType::real* xv = hepevt_.vhep[i];
     FourVector        pos(xv[0],xv[1],xv[2],xv[3]);
     pos = _booster.rapidityBoost(-1, pos);
     
-    return make<VertexPtr>(pos);
+    return _factory.vertex(pos);
   }
   /**
    * Get indexes of mother particles - if any. 
@@ -377,7 +406,7 @@ protected:
    * 
    * @return particle i 
    */
-  ParticlePtr getParticle(int i, int& offsh) const
+  ParticlePtr getParticle(int i, int& offsh)
   {
     HepEvtType::real* pv   =  hepevt_.phep  [i];
     int               pdg  =  hepevt_.idhep [i];
@@ -396,7 +425,7 @@ protected:
     }
     mom = _booster.rapidityBoost(mom, mas);
 
-    ParticlePtr g = make<ParticlePtr>(mom,pdg,sts);
+    ParticlePtr g = _factory.particle(mom,pdg,sts);
     g->set_generated_mass(mas);
 
     return g;
@@ -404,21 +433,53 @@ protected:
   /** 
    * Generate particle i and any of it's mothers that are not done yet.  
    *
+   * Mothers are generated before their daughters (first mother
+   * first), walking up the mother links with an explicit stack
+   * rather than by recursion, so that long decay chains do not
+   * exhaust the call stack.  Mother links that point outside the
+   * record or back to a particle in progress (a loop) are ignored.
+   *
    * @param i  index into HEPEVT 
    */
   ParticlePtr genParticle(int i)
   {
-    if (_particles[i]) return _particles[i];
-    
-    // Get mothers
-    auto mth = getMothers(i);
+    if (_state[i] == kDone) return _particles[i];
+
+    _stack.clear();
+    _stack.push_back(i);
+    _state[i] = kInProgress;
+    while (not _stack.empty()) {
+      int  j   = _stack.back();
+      auto mth = getMothers(j);
 
-    // Generate mothers if needed
-    ParticlePtr m1 = 0;
-    ParticlePtr m2 = 0;
-    if (mth.first  >= 0) m1 = genParticle(mth.first);
-    if (mth.second >= 0) m2 = genParticle(mth.second);
+      // Generate mothers if needed
+      int next = -1;
+      if      (isNew(mth.first))  next = mth.first;
+      else if (isNew(mth.second)) next = mth.second;
+      if (next >= 0) {
+	_state[next] = kInProgress;
+	_stack.push_back(next);
+	continue;
+      }
 
+      ParticlePtr m1 = isDone(mth.first)  ? _particles[mth.first]  : 0;
+      ParticlePtr m2 = isDone(mth.second) ? _particles[mth.second] : 0;
+      makeParticle(j, m1, m2);
+      _state[j] = kDone;
+      _stack.pop_back();
+    }
+    return _particles[i];
+  }
+  /** 
+   * Generate particle i once its mothers exist and attach it to the
+   * vertex structure.
+   *
+   * @param i   index into HEPEVT 
+   * @param m1  first mother or null
+   * @param m2  second mother or null
+   */
+  void makeParticle(int i, ParticlePtr m1, ParticlePtr m2)
+  {
     // Generate the particle 
     _particles[i] = getParticle(i, _offshell);
     auto&  p      = _particles[i];
@@ -442,21 +503,35 @@ protected:
     
     // Set as beam if status tells us so
     if (p->status() == 4) _beams.push_back(p);
-
-    return p;
-  };
+  }
+  /** State of a HEPEVT entry during the conversion */
+  enum { kNew, kInProgress, kDone };
+  bool isNew(int i) const
+  {
+    return i >= 0 and i < int(_state.size()) and _state[i] == kNew;
+  }
+  bool isDone(int i) const
+  {
+    return i >= 0 and i < int(_state.size()) and _state[i] == kDone;
+  }
   /** Internal cache of particles */
   ParticleVector _particles;
   /** Beam particles */
   ParticleVector _beams;
   /** Internal cache of vertices */
   VertexVector   _vertices;
+  /** Conversion state of each entry, kept between events */
+  std::vector<char> _state;
+  /** Entries waiting for their mothers, kept between events */
+  std::vector<int> _stack;
   /** Number of off-shell particles in event */
   int _offshell;
   /** Force particles on-shell */
   bool _putOnShell;
   /** Rapidity booster */
   Boost _booster;
+  /** Creates particles and vertices */
+  Factory _factory;
 };
 #endif
 //
@@ -0,0 +1,94 @@
+// -*- mode: C++ -*-
+/**
+ * @file      src/CRMChepmc2pool.h
+ *
+ * @brief  Recycles HepMC::GenParticle and HepMC::GenVertex between events
+ */
+#ifndef CRMChepmc2pool_h
+#define CRMChepmc2pool_h
+#include <HepMC/GenEvent.h>
+#include <HepMC/GenParticle.h>
+#include <HepMC/GenVertex.h>
+#include <vector>
+
+/**
+ * Factory for CRMChepevt (see CRMCmakeFactory) which hands out the
+ * particles and vertices of the previous event again instead of
+ * allocating new ones.
+ *
+ * The pool keeps ownership of everything it hands out.  An event
+ * filled from the pool must therefore never delete its vertices: it
+ * is kept alive by the caller and emptied by reset() (called by
+ * CRMChepevt::convert) which takes the vertices out of the event and
+ * the particles out of the vertices.
+ *
+ * @ingroup model
+ */
+struct CRMChepmc2pool
+{
+  using ParticlePtr=HepMC::GenParticle*;
+  using VertexPtr=HepMC::GenVertex*;
+
+  CRMChepmc2pool() : _nParticles(0), _nVertices(0) {}
+  /** Objects must not belong to an event anymore, see reset() */
+  ~CRMChepmc2pool()
+  {
+    for (auto v : _vertices)  delete v;
+    for (auto p : _particles) delete p;
+  }
+
+  /**
+   * Detach all objects handed out since the last reset from their
+   * event and from each other, so they can be handed out again.
+   */
+  void reset()
+  {
+    for (size_t i = 0; i < _nVertices; i++) {
+      VertexPtr v = _vertices[i];
+      if (v->parent_event()) v->parent_event()->remove_vertex(v);
+      while (v->particles_in_size())
+	v->remove_particle(*v->particles_in_const_begin());
+      while (v->particles_out_size())
+	v->remove_particle(*v->particles_out_const_begin());
+      // let the next event number them as if they were new
+      v->suggest_barcode(0);
+    }
+    for (size_t i = 0; i < _nParticles; i++)
+      _particles[i]->suggest_barcode(0);
+    _nParticles = 0;
+    _nVertices  = 0;
+  }
+  /** Get a vertex at pos */
+  VertexPtr vertex(const HepMC::FourVector& pos)
+  {
+    if (_nVertices == _vertices.size())
+      _vertices.push_back(new HepMC::GenVertex(pos));
+    else
+      _vertices[_nVertices]->set_position(pos);
+    return _vertices[_nVertices++];
+  }
+  /** Get a particle */
+  ParticlePtr particle(const HepMC::FourVector& mom, int pdg, int sts)
+  {
+    if (_nParticles == _particles.size()) {
+      _particles.push_back(new HepMC::GenParticle(mom,pdg,sts));
+      return _particles[_nParticles++];
+    }
+    ParticlePtr p = _particles[_nParticles++];
+    p->set_momentum(mom);
+    p->set_pdg_id(pdg);
+    p->set_status(sts);
+    return p;
+  }
+protected:
+  /** All particles ever created, the first _nParticles are in use */
+  std::vector<ParticlePtr> _particles;
+  /** All vertices ever created, the first _nVertices are in use */
+  std::vector<VertexPtr> _vertices;
+  size_t _nParticles;
+  size_t _nVertices;
+};
+#endif
+//
+// EOF
+//
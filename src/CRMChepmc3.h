@@ -23,15 +23,20 @@
 struct CRMChepmc3
 {
   /** Constructor */
-  CRMChepmc3() :_ion(0), _xsec(0) {}
+  CRMChepmc3() :_ion(0), _xsec(0), _perEvent(false) {}
 
   /** 
    * Initialize this helper.  Queries the configuration if the
    * collisions are ion-like and then creates the heavy-ion header if
    * that is the case.  
+   *
+   * By default the same header objects are attached to every event.
+   * If events are still in use when the next one is filled (e.g. by
+   * other threads) set perEvent, so that each event gets its own.
    */
-  void init(const CRMCoptions& cfg)
+  void init(const CRMCoptions& cfg, bool perEvent=false)
   {
+    _perEvent = perEvent;
     if (cfg.GetProjectileId() > 1 || cfg.GetTargetId() > 1)
       _ion  = std::make_shared<HepMC3::GenHeavyIon>();
     _xsec = std::make_shared<HepMC3::GenCrossSection>();
@@ -48,6 +53,11 @@ struct CRMChepmc3
   {
     event.set_event_number(evno);
 
+    if (_perEvent) {
+      _xsec = std::make_shared<HepMC3::GenCrossSection>();
+      if (_ion) _ion = std::make_shared<HepMC3::GenHeavyIon>();
+    }
+
     _xsec->set_cross_section(1e9 * (_ion ?
 				    gCRMC_data.sigineaa : 
 				    gCRMC_data.sigine), 0);
@@ -75,6 +85,8 @@ struct CRMChepmc3
   HepMC3::GenHeavyIonPtr _ion;
   /** Cross-section */
   HepMC3::GenCrossSectionPtr _xsec;
+  /** New header objects for every event */
+  bool _perEvent;
 };
 #endif
 //
@@ -20,11 +20,24 @@ using namespace std;
 
 CRMCdata gCRMC_data;
 
+void CRMCdata::Store(const int typout)
+{
+  // hepmcstore only distinguishes negative output types
+  if (!fStore || (typout < 0) == (fTypout < 0))
+    return;
+  fStore(typout, fNParticles, fImpactParameter, fPartId[0], fPartPx[0], fPartPy[0],
+         fPartPz[0], fPartEnergy[0], fPartMass[0], fPartStatus[0]);
+  fTypout = typout;
+}
+
 CRMCinterface::CRMCinterface() :
   crmc_generate(NULL),
   crmc_set(NULL),
+  crmc_reseed(NULL),
+  crmc_store(NULL),
   crmc_init(NULL),
   crmc_xsection(NULL),
+  crmc_tables(NULL),
   fLibrary(NULL)
 {
 }
@@ -54,12 +67,15 @@ bool CRMCinterface::init(int HEmodel)
 #ifdef CRMC_STATIC
   crmc_generate  = &crmc_f_;
   crmc_set       = &crmc_set_f_;
+  crmc_reseed    = &crmc_reseed_f_;
+  crmc_store     = &crmc_store_f_;
   crmc_init      = &crmc_init_f_;
   crmc_xsection  = &crmc_xsection_f_;
   crmc_defaults  = &aaset_;
   crmc_readparam = &eposinput_;
   crmc_pid       = &idtrafo_;
   crmc_ainit     = &ainit_;
+  crmc_tables    = &tabcacherecord_;
 #else
   ostringstream libname;
   if (!fLibrary)
@@ -106,12 +122,15 @@ bool CRMCinterface::init(int HEmodel)
 
   crmc_generate  = (generate_t) find_symbol("crmc_f_");
   crmc_set       = (set_t)      find_symbol("crmc_set_f_");
+  crmc_reseed    = (reseed_t)   find_symbol("crmc_reseed_f_");
+  crmc_store     = (store_t)    find_symbol("crmc_store_f_");
   crmc_init      = (init_t)     find_symbol("crmc_init_f_");
   crmc_xsection  = (xsection_t) find_symbol("crmc_xsection_f_");
   crmc_defaults  = (defaults_t) find_symbol("aaset_");
   crmc_readparam = (readparam_t)find_symbol("eposinput_");
   crmc_ainit     = (ainit_t)    find_symbol("ainit_");
   crmc_pid       = (pid_t)      find_symbol("idtrafo_");
+  crmc_tables    = (tables_t)   dlsym(fLibrary, "tabcacherecord_"); // optional
   
   //common blocks from library are not used. they come from DummyHepEvt library
   //grabbed in header with extern "C"
@@ -49,17 +49,35 @@ CRMCoptions::CRMCoptions(int argc, char **argv)
     , fTargetId(1)
     , fHEModel(0)
     , fTypout(0)
+    , fShardEvents(0)
+    , fShardBytes(0)
+    , fShmSlots(16)
+    , fShmTimeout(300)
+    , fBlockEvents(0)
+    , fRivetThreads(0)
+    , fRootBranches()
+    , fRootPrecision("double")
+    , fRootFinalOnly(false)
     , fProjectileMomentum(3500)
     , fTargetMomentum(-3500)
     , fParamFileName("crmc.param ")
     , fOutputFileName("")
     , fRHICfRunType("")
     , fJobIndex("")
+    , fReplayFileName("")
+    , fHistConfigName("")
+    , fProfileStartupName("")
+    , fPileupBankName("")
+    , fPileupMu(0)
     , fRivetAnalyses()
     , fRivetSearch()
     , fRivetPreloads()
+    , fOutputSinks()
+    , fRegenerate()
     , fProduceTables(false)
     , fSeedProvided(false)
+    , fEventSeeds(false)
+    , fSeedsOnly(false)
     , fTest(false)
     , fCSMode(false)
 {
@@ -142,7 +160,8 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
   TCLAP::ValueArg<string> output("o",
                                  "output_mode",
                                  "hepmc, hepmcgz (default), root, lhe, lhegz, rivet"
-                                 "hepmc2, hepmc2gz, hepmc3, hepmc3gz",
+                                 "hepmc2, hepmc2gz, hepmc3, hepmc3gz, shm, "
+                                 "hepmc3file, hepmc3filegz, hepmc3root, hist",
                                  false, // required
 #if WITH_HEPMC3
                                  "hepmcgz", // default
@@ -199,6 +218,66 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
     "J", "jobIndex", "Specific job index", false, "", "string");
   cmd.add(jobIndex);
 
+  TCLAP::ValueArg<int> shardEvents(
+    "", "shard-events", "start a new output file every N written events (0: off)", false, 0, "int");
+  cmd.add(shardEvents);
+
+  TCLAP::ValueArg<long long> shardBytes(
+    "", "shard-bytes", "start a new output file once it reaches N bytes (0: off)", false, 0, "long");
+  cmd.add(shardBytes);
+
+  TCLAP::ValueArg<int> blockEvents(
+    "", "block-events",
+    "gzip output (hepmc2gz, hepmc3filegz) in independent blocks of N events "
+    "with an index file (0: off)", false, 0, "int");
+  cmd.add(blockEvents);
+
+  TCLAP::ValueArg<int> shmSlots(
+    "", "shm-slots", "number of events buffered in shared memory (-o shm)", false, 16, "int");
+  cmd.add(shmSlots);
+
+  TCLAP::ValueArg<double> shmTimeout(
+    "", "shm-timeout",
+    "seconds to wait for a consumer to attach to the shared memory (-o shm, 0: no limit)",
+    false, 300, "double");
+  cmd.add(shmTimeout);
+
+  TCLAP::SwitchArg eventSeeds(
+    "", "event-seeds",
+    "restart the random numbers for every collision with a seed derived from "
+    "the run seed and the collision number", false);
+  cmd.add(eventSeeds);
+
+  TCLAP::SwitchArg seedsOnly(
+    "", "seeds-only",
+    "hepmc3 (RHICf) output: write only the Summary tree with the event seeds, "
+    "no particles (implies --event-seeds)", false);
+  cmd.add(seedsOnly);
+
+  TCLAP::ValueArg<string> regenerate(
+    "", "regenerate",
+    "generate again the collisions listed in the file, one \"collision seed\" per line",
+    false, "", "string");
+  cmd.add(regenerate);
+
+  TCLAP::ValueArg<string> replay(
+    "", "replay",
+    "read the events of an earlier run (hepmc, hepmc3file, RHICf root) instead "
+    "of generating them, all of them unless -n is given",
+    false, "", "string");
+  cmd.add(replay);
+
+  TCLAP::ValueArg<string> pileupBank(
+    "", "pileup-bank",
+    "overlay pileup collisions read from this file (formats of --replay)",
+    false, "", "string");
+  cmd.add(pileupBank);
+
+  TCLAP::ValueArg<double> pileupMu(
+    "", "pileup-mu", "mean number of pileup collisions per event (Poisson)",
+    false, 0, "double");
+  cmd.add(pileupMu);
+
   TCLAP::SwitchArg tables("t", "produce-tables", "create tables if none are found", true);
   cmd.add(tables);
 
@@ -225,6 +304,45 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
       "L", "preload", "add preloaded data to Rivet", false, "string");
   cmd.add(preload);
 
+  TCLAP::ValueArg<int> rivetThreads(
+      "", "rivet-threads", "run the Rivet analyses in N threads (0: in the generator thread)",
+      false, 0, "int");
+  cmd.add(rivetThreads);
+
+  TCLAP::ValueArg<string> histConfig(
+      "", "hist-config", "file with the histograms to fill (-o hist)", false, "", "string");
+  cmd.add(histConfig);
+
+  TCLAP::ValueArg<string> profileStartup(
+      "", "profile-startup",
+      "print wall time and peak memory of the start-up phases and tables up to the first "
+      "event, and write them as JSON to the given file ('-': print only)",
+      false, "", "string");
+  cmd.add(profileStartup);
+
+  TCLAP::ValueArg<string> rootBranches(
+      "", "root-branches",
+      "comma separated particle branches of the root output (default all): "
+      "ImpactParameter,ProcessID,pdgid,status,px,py,pz,E,m",
+      false, "", "string");
+  cmd.add(rootBranches);
+
+  TCLAP::ValueArg<string> rootPrecision(
+      "", "root-precision", "storage of momenta in the root output: double (default), float, reduced",
+      false, "double", "string");
+  cmd.add(rootPrecision);
+
+  TCLAP::SwitchArg rootFinalOnly(
+      "", "root-final-only", "store only final state particles in the root output", false);
+  cmd.add(rootFinalOnly);
+
+  TCLAP::MultiArg<string> sinks(
+      "O", "sink",
+      "additional output written from the same events, as mode[:file] "
+      "(accepted multiple times)",
+      false, "string");
+  cmd.add(sinks);
+
   try
   {
     cmd.parse(argc, argv);
@@ -235,91 +353,21 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
     exit(EXIT_FAILURE);
   }
 
-  const string om = output.getValue();
-  if (om == "hepmc3gz") // ---------------- HepMC3 + gzip
-  {
-#ifndef WITH_HEPMC3
-    cerr << " Compile with HepMC3 first " << endl;
-    exit(1);
-#endif
-    fOutputMode = eHepMC3GZ;
-  }
-  else if (om == "hepmc3") // ------------ HepMC3
-  {
-#ifndef WITH_HEPMC3
-    cerr << " Compile with HepMC3 first " << endl;
-    exit(1);
-#endif
-    fOutputMode = eHepMC3;
-  }
-  else if (om == "hepmc2gz") // ------------- HepMC2 + gzip
-  {
-#ifndef WITH_HEPMC
-    cerr << " Compile with HepMC2 first " << endl;
-    exit(1);
-#endif
-    fOutputMode = eHepMCGZ;
-  }
-  else if (om == "hepmc2") // --------------- HepMC2
-  {
-#ifndef WITH_HEPMC
-    cerr << " Compile with HepMC2 first " << endl;
-    exit(1);
-#endif
-    fOutputMode = eHepMC;
-  }
-  else if (om == "hepmcgz") // ---------- generic HepMC2 or HepMC3 + gzip
-  {
-#if WITH_HEPMC3
-    fOutputMode = eHepMC3GZ;
-#elif WITH_HEPMC
-    fOutputMode = eHepMCGZ;
-#else
-    cerr << " Compile with HepMC3 or HepMC2 first " << endl;
-    exit(1);
-#endif
-  }
-  else if (om == "hepmc") // ------------------- generic HepMC2 or HepMC3
-  {
-#if WITH_HEPMC3
-    fOutputMode = eHepMC3;
-#elif WITH_HEPMC
-    fOutputMode = eHepMC;
-#else
-    cerr << " Compile with HepMC3 or HepMC2 first " << endl;
-    exit(1);
-#endif
-  }
-  else if (om == "lhe") // ------- LHE
-  {
-    fOutputMode = eLHE;
-  }
-  else if (om == "lhegz")
-  {
-    fOutputMode = eLHEGZ;
-  }
-  else if (om == "rivet")
-  {
-#ifndef WITH_RIVET
-    cerr << " Compile with Rivet first " << endl;
-    exit(1);
-#endif
-    fOutputMode = eRivet;
-  }
-  else if (om == "root")
-  {
-#ifdef WITH_ROOT
-    fOutputMode = eROOT;
-#else
-    cerr << " Compile with ROOT first " << endl;
-    exit(1);
-#endif
-  }
-  else
+  fOutputMode = ParseOutputMode(output.getValue());
+
+  for (const auto &spec : sinks.getValue())
   {
-    cerr << " Wrong output type: " << om << endl;
-    cerr << " Check --help for more information" << endl;
-    exit(1);
+    const size_t colon = spec.find(':');
+    OutputSink sink;
+    sink.fMode = ParseOutputMode(spec.substr(0, colon));
+    sink.fFileName = (colon == string::npos ? "" : spec.substr(colon + 1));
+    if (sink.fMode == eLHE || sink.fMode == eLHEGZ)
+    {
+      // LHE is written by the Fortran code itself, see crmc_init_f
+      cerr << " LHE output cannot be used as additional sink: " << spec << endl;
+      exit(1);
+    }
+    fOutputSinks.push_back(sink);
   }
 
   // check if either sqrt(s) or the momenta option was used
@@ -329,13 +377,7 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
     exit(1);
   }
 
-  if (fOutputMode == eLHE || fOutputMode == eLHEGZ)
-    fTypout = 1;
-
-#ifdef WITH_ROOT
-  if (fOutputMode == eROOT)
-    fTypout = -1;
-#endif
+  fTypout = TypoutFor(fOutputMode);
 
   // parameter readout
   if (seed.isSet())
@@ -387,6 +429,36 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
   if (jobIndex.isSet())
     fJobIndex = jobIndex.getValue();
 
+  fShardEvents = shardEvents.getValue();
+  fShardBytes = shardBytes.getValue();
+  if (fShardEvents < 0 || fShardBytes < 0)
+  {
+    cerr << " Shard size is negative: " << fShardEvents << " events, " << fShardBytes
+         << " bytes" << endl;
+    exit(1);
+  }
+
+  fBlockEvents = blockEvents.getValue();
+  if (fBlockEvents < 0)
+  {
+    cerr << " Number of events per block is negative: " << fBlockEvents << endl;
+    exit(1);
+  }
+
+  fShmSlots = shmSlots.getValue();
+  if (fShmSlots < 1)
+  {
+    cerr << " Number of shared memory slots must be positive: " << fShmSlots << endl;
+    exit(1);
+  }
+
+  fShmTimeout = shmTimeout.getValue();
+  if (fShmTimeout < 0)
+  {
+    cerr << " Shared memory timeout is negative: " << fShmTimeout << endl;
+    exit(1);
+  }
+
   if (tables.getValue())
     fProduceTables = tables.getValue();
 
@@ -415,6 +487,138 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
     fNCollision = 1;
   }
 
+  if ((fTest || fCSMode) && !fOutputSinks.empty())
+  {
+    cerr << " Additional output sinks cannot be used in test or cross-section mode" << endl;
+    exit(1);
+  }
+
+  // root output layout
+  if (rootBranches.isSet())
+  {
+    const string known = ",ImpactParameter,ProcessID,pdgid,status,px,py,pz,E,m,";
+    istringstream branches(rootBranches.getValue());
+    string branch;
+    while (getline(branches, branch, ','))
+    {
+      if (branch.empty())
+        continue;
+      if (known.find("," + branch + ",") == string::npos)
+      {
+        cerr << " Unknown root branch: " << branch << endl;
+        exit(1);
+      }
+      fRootBranches.push_back(branch);
+    }
+  }
+  fRootPrecision = rootPrecision.getValue();
+  if (fRootPrecision != "double" && fRootPrecision != "float" && fRootPrecision != "reduced")
+  {
+    cerr << " Wrong root precision: " << fRootPrecision << endl;
+    cerr << " Check --help for more information" << endl;
+    exit(1);
+  }
+  fRootFinalOnly = rootFinalOnly.getValue();
+
+  // only the file based event records know how to rotate their files
+  if (IsSharded())
+  {
+    bool canShard = (fOutputMode == eHepMC || fOutputMode == eHepMCGZ
+                     || fOutputMode == eHepMC3 || fOutputMode == eHepMC3GZ);
+    for (const auto &sink : fOutputSinks)
+      canShard = canShard && (sink.fMode == eHepMC || sink.fMode == eHepMCGZ
+                              || sink.fMode == eHepMC3 || sink.fMode == eHepMC3GZ);
+    if (fTest || fCSMode || !canShard)
+    {
+      cerr << " Output sharding is only available for hepmc and hepmc3 output" << endl;
+      exit(1);
+    }
+  }
+
+  if (fBlockEvents > 0 && !HasOutputMode(eHepMCGZ) && !HasOutputMode(eHepMC3FileGZ))
+  {
+    cerr << " Block compression is only available for hepmc2gz and hepmc3filegz output" << endl;
+    exit(1);
+  }
+
+  // per event seeds
+  fEventSeeds = eventSeeds.getValue();
+  fSeedsOnly = seedsOnly.getValue();
+  if (fSeedsOnly)
+  {
+    if (fOutputMode != eHepMC3 && fOutputMode != eHepMC3GZ)
+    {
+      cerr << " --seeds-only is only available for hepmc3 (RHICf) output" << endl;
+      exit(1);
+    }
+    fEventSeeds = true;
+  }
+  if (regenerate.isSet())
+  {
+    ifstream list(regenerate.getValue().c_str());
+    if (!list.is_open())
+    {
+      cerr << " Cannot open list of events to regenerate: " << regenerate.getValue() << endl;
+      exit(1);
+    }
+    string line;
+    while (getline(list, line))
+    {
+      if (line.empty() || line[0] == '#')
+        continue;
+      istringstream fields(line);
+      EventSeed event;
+      if (!(fields >> event.fCollision >> event.fSeed) || event.fSeed <= 0 || event.fSeed >= 1e9)
+      {
+        cerr << " Wrong line in " << regenerate.getValue() << ": " << line << endl;
+        exit(1);
+      }
+      fRegenerate.push_back(event);
+    }
+    if (fRegenerate.empty())
+    {
+      cerr << " No event to regenerate in " << regenerate.getValue() << endl;
+      exit(1);
+    }
+    if (fSeedsOnly || fTest || fCSMode)
+    {
+      cerr << " --regenerate cannot be used with --seeds-only, test or cross-section mode" << endl;
+      exit(1);
+    }
+    fEventSeeds = true;
+  }
+
+  if (replay.isSet())
+  {
+    fReplayFileName = replay.getValue();
+    if (fEventSeeds || fTest || fCSMode || HasOutputMode(eLHE) || HasOutputMode(eLHEGZ))
+    {
+      cerr << " --replay cannot be used with event seeds, test, cross-section mode or LHE output"
+           << endl;
+      exit(1);
+    }
+    if (!number.isSet())
+      fNCollision = -1; // until the end of the file
+  }
+
+  if (pileupBank.isSet() || pileupMu.isSet())
+  {
+    fPileupBankName = pileupBank.getValue();
+    fPileupMu = pileupMu.getValue();
+    if (fPileupBankName.empty() || fPileupMu <= 0)
+    {
+      cerr << " Pileup needs a bank file (--pileup-bank) and a positive mean (--pileup-mu)"
+           << endl;
+      exit(1);
+    }
+    // the bank is read in sequence, a single event cannot be reproduced
+    if (fEventSeeds || fTest || fCSMode)
+    {
+      cerr << " Pileup cannot be used with event seeds, test or cross-section mode" << endl;
+      exit(1);
+    }
+  }
+
   // check if random seed was provided, otherwise generate one
   fSeedProvided = fSeed;
   if (!fSeedProvided)
@@ -453,18 +657,47 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
   {
     fRivetAnalyses.insert(fRivetAnalyses.end(),analysis.begin(),analysis.end());
   }
-  else if (fOutputMode == eRivet)
+  else if (HasOutputMode(eRivet))
   {
     cerr << " Rivet output required analysis to be specified. Check help. " << endl;
     exit(1);
   }
+  fRivetThreads = rivetThreads.getValue();
+  if (fRivetThreads < 0)
+  {
+    cerr << " Number of Rivet threads is negative: " << fRivetThreads << endl;
+    exit(1);
+  }
   if (include.isSet())
     fRivetSearch.insert(fRivetSearch.end(),include.begin(),include.end());
   if (preload.isSet())
     fRivetPreloads.insert(fRivetPreloads.end(),preload.begin(),preload.end());
 
-  if (!(fOutputMode == eRivet)
-      && (!fRivetAnalyses.empty() || !fRivetPreloads.empty() || !fRivetSearch.empty()))
+  fHistConfigName = histConfig.getValue();
+  fProfileStartupName = profileStartup.getValue();
+  if (HasOutputMode(eHistograms) && fHistConfigName.empty())
+  {
+    cerr << " Histogram output requires the histogram definitions (--hist-config)" << endl;
+    exit(1);
+  }
+
+  // every sink needs its own file
+  for (size_t i = 0; i < fOutputSinks.size(); ++i)
+  {
+    const string sinkFile = ForOutputSink(fOutputSinks[i]).GetOutputFileName();
+    bool clash = (sinkFile == GetOutputFileName());
+    for (size_t j = 0; j < i; ++j)
+      clash = clash || (sinkFile == ForOutputSink(fOutputSinks[j]).GetOutputFileName());
+    if (clash)
+    {
+      cerr << " Output file used by more than one sink: " << sinkFile << endl;
+      exit(1);
+    }
+  }
+
+  if (!HasOutputMode(eRivet)
+      && (!fRivetAnalyses.empty() || !fRivetPreloads.empty() || !fRivetSearch.empty()
+          || fRivetThreads > 0))
   {
     cerr << "You specified Rivet-specific options, but not Rivet as output format... Why?"
          << endl;
@@ -474,6 +707,171 @@ void CRMCoptions::ParseOptions(int argc, char **argv)
   DumpConfig();
 }
 
+CRMCoptions::EOutputMode CRMCoptions::ParseOutputMode(const string &om) const
+{
+  if (om == "hepmc3gz") // ---------------- HepMC3 + gzip
+  {
+#ifndef WITH_HEPMC3
+    cerr << " Compile with HepMC3 first " << endl;
+    exit(1);
+#endif
+    return eHepMC3GZ;
+  }
+  else if (om == "hepmc3") // ------------ HepMC3
+  {
+#ifndef WITH_HEPMC3
+    cerr << " Compile with HepMC3 first " << endl;
+    exit(1);
+#endif
+    return eHepMC3;
+  }
+  else if (om == "hepmc3filegz") // -------- HepMC3 event file + gzip
+  {
+#ifndef WITH_HEPMC3
+    cerr << " Compile with HepMC3 first " << endl;
+    exit(1);
+#endif
+    return eHepMC3FileGZ;
+  }
+  else if (om == "hepmc3file") // ---------- HepMC3 event file
+  {
+#ifndef WITH_HEPMC3
+    cerr << " Compile with HepMC3 first " << endl;
+    exit(1);
+#endif
+    return eHepMC3File;
+  }
+  else if (om == "hepmc3root") // ---------- HepMC3 event file as ROOT tree
+  {
+#ifndef WITH_HEPMC3_ROOTIO
+    cerr << " Compile with HepMC3 ROOT I/O first " << endl;
+    exit(1);
+#endif
+    return eHepMC3Root;
+  }
+  else if (om == "hepmc2gz") // ------------- HepMC2 + gzip
+  {
+#ifndef WITH_HEPMC
+    cerr << " Compile with HepMC2 first " << endl;
+    exit(1);
+#endif
+    return eHepMCGZ;
+  }
+  else if (om == "hepmc2") // --------------- HepMC2
+  {
+#ifndef WITH_HEPMC
+    cerr << " Compile with HepMC2 first " << endl;
+    exit(1);
+#endif
+    return eHepMC;
+  }
+  else if (om == "hepmcgz") // ---------- generic HepMC2 or HepMC3 + gzip
+  {
+#if WITH_HEPMC3
+    return eHepMC3GZ;
+#elif WITH_HEPMC
+    return eHepMCGZ;
+#else
+    cerr << " Compile with HepMC3 or HepMC2 first " << endl;
+    exit(1);
+#endif
+  }
+  else if (om == "hepmc") // ------------------- generic HepMC2 or HepMC3
+  {
+#if WITH_HEPMC3
+    return eHepMC3;
+#elif WITH_HEPMC
+    return eHepMC;
+#else
+    cerr << " Compile with HepMC3 or HepMC2 first " << endl;
+    exit(1);
+#endif
+  }
+  else if (om == "lhe") // ------- LHE
+  {
+    return eLHE;
+  }
+  else if (om == "lhegz")
+  {
+    return eLHEGZ;
+  }
+  else if (om == "rivet")
+  {
+#ifndef WITH_RIVET
+    cerr << " Compile with Rivet first " << endl;
+    exit(1);
+#endif
+    return eRivet;
+  }
+  else if (om == "shm")
+  {
+    return eSharedMemory;
+  }
+  else if (om == "hist")
+  {
+#ifdef WITH_ROOT
+    return eHistograms;
+#else
+    cerr << " Compile with ROOT first " << endl;
+    exit(1);
+#endif
+  }
+  else if (om == "root")
+  {
+#ifdef WITH_ROOT
+    return eROOT;
+#else
+    cerr << " Compile with ROOT first " << endl;
+    exit(1);
+#endif
+  }
+  else
+  {
+    cerr << " Wrong output type: " << om << endl;
+    cerr << " Check --help for more information" << endl;
+    exit(1);
+  }
+
+  return eNone;
+}
+
+
+bool CRMCoptions::HasOutputMode(const EOutputMode mode) const
+{
+  if (fOutputMode == mode)
+    return true;
+  for (const auto &sink : fOutputSinks)
+    if (sink.fMode == mode)
+      return true;
+  return false;
+}
+
+
+CRMCoptions CRMCoptions::ForOutputSink(const OutputSink &sink) const
+{
+  CRMCoptions sinkCfg(*this);
+  sinkCfg.fOutputMode = sink.fMode;
+  sinkCfg.fOutputFileName = sink.fFileName;
+  sinkCfg.fOutputSinks.clear();
+  // the event is stored again for this sink if it differs (CRMCdata::Store)
+  sinkCfg.fTypout = TypoutFor(sink.fMode);
+  return sinkCfg;
+}
+
+int CRMCoptions::TypoutFor(const EOutputMode mode)
+{
+  if (mode == eLHE || mode == eLHEGZ)
+    return 1;
+#ifdef WITH_ROOT
+  if (mode == eROOT)
+    return -1;
+#endif
+  // same particle list as the ROOT output, see CRMCshm.h
+  if (mode == eSharedMemory)
+    return -1;
+  return 0;
+}
+
 string CRMCoptions::ParticleName(const int pid) const
 {
   if (pid < 10000)
@@ -646,6 +1044,9 @@ void CRMCoptions::DumpConfig() const
       case eRivet:
         cout << "RIVET\n";
         break;
+      case eHistograms:
+        cout << "ROOT histograms\n";
+        break;
       default:
         cout << "unknown\n";
     }
@@ -709,7 +1110,39 @@ void CRMCoptions::DumpConfig() const
   }
   cout << endl;
 
-  if (fOutputMode == eRivet)
+  if (IsSharded())
+  {
+    cout << "Output shards: ";
+    if (fShardEvents > 0)
+      cout << fShardEvents << " events ";
+    if (fShardBytes > 0)
+      cout << fShardBytes << " bytes ";
+    cout << "per file" << endl;
+  }
+
+  if (IsReplay())
+    cout << "Replaying events from " << fReplayFileName << endl;
+  else if (IsRegenerate())
+    cout << "Regenerating " << fRegenerate.size() << " listed collisions" << endl;
+  else if (fEventSeeds)
+    cout << "Random numbers restarted for every collision"
+         << (fSeedsOnly ? ", only seeds and summary written" : "") << endl;
+
+  if (IsPileup())
+    cout << "Pileup of " << fPileupMu << " collisions on average from " << fPileupBankName
+         << endl;
+
+  if (fBlockEvents > 0)
+    cout << "Compressed blocks of " << fBlockEvents << " events (index in .idx file)" << endl;
+
+  if (!fOutputSinks.empty())
+  {
+    cout << "Additional output sinks:" << endl;
+    for (const auto &sink : fOutputSinks)
+      cout << "   - " << ForOutputSink(sink).GetOutputFileName() << endl;
+  }
+
+  if (HasOutputMode(eRivet))
   {
     cout << "Rivet analyses:" << endl;
     for (auto ana : fRivetAnalyses)
@@ -720,6 +1153,8 @@ void CRMCoptions::DumpConfig() const
     cout << "Rivet preloads: " << (fRivetPreloads.empty() ? "n/a" : "") << endl;
     for (auto pre : fRivetPreloads)
       cout << "   - " << pre << endl;
+    if (fRivetThreads > 0)
+      cout << "Rivet threads: " << fRivetThreads << endl;
   }
 
   cout.setf(ios::showpoint);
@@ -741,12 +1176,21 @@ string CRMCoptions::GetOutputTypeEnding() const
       break;
 #endif
 #ifdef WITH_HEPMC3
-    case eHepMC3:
+    case eHepMC3: // RHICf trees, see OutputPolicyHepMC3
+    case eHepMC3GZ:
+      return ".RHICfSimGenerator.root";
+      break;
+    case eHepMC3File:
       return ".hepmc";
       break;
-    case eHepMC3GZ:
+    case eHepMC3FileGZ:
       return ".hepmc.gz";
       break;
+#endif
+#ifdef WITH_HEPMC3_ROOTIO
+    case eHepMC3Root:
+      return ".hepmc.root";
+      break;
 #endif
     case eLHE:
       return ".lhe";
@@ -758,16 +1202,51 @@ string CRMCoptions::GetOutputTypeEnding() const
     case eROOT:
       return ".root";
       break;
+    case eHistograms:
+      return ".hist.root";
+      break;
 #endif
 #ifdef WITH_RIVET
     case eRivet:
       return ".yoda";
       break;
 #endif
+    case eSharedMemory:
+      return ".shm";
+      break;
   }
   return ".unknown";
 }
 
+int CRMCoptions::GetEventSeed(const int collision) const
+{
+  // splitmix64 of (run seed, collision): neighbouring collisions get
+  // unrelated seeds, within the range accepted by the generator (1..1e9-1)
+  unsigned long long z = ((unsigned long long)fSeed << 32) + (unsigned int)collision;
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+  return int(z % 999999999ULL) + 1;
+}
+
+string CRMCoptions::GetShardFileName(const string &fileName,
+                                     const string &ending,
+                                     const int shard) const
+{
+  // crmc_..._7000.hepmc.gz -> crmc_..._7000_shard0003.hepmc.gz
+  ostringstream tag;
+  tag << "_shard" << setw(4) << setfill('0') << shard;
+
+  string shardName = fileName;
+  if (shardName.size() > ending.size()
+      && shardName.compare(shardName.size() - ending.size(), ending.size(), ending) == 0)
+    shardName.insert(shardName.size() - ending.size(), tag.str());
+  else
+    shardName += tag.str();
+  return shardName;
+}
+
 string CRMCoptions::GetOutputFileName() const
 {
   // open output file and connect tree
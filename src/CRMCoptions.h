@@ -16,13 +16,30 @@ class CRMCoptions {
     eHepMCGZ,
     eHepMC3,
     eHepMC3GZ,
+    eHepMC3File,
+    eHepMC3FileGZ,
+    eHepMC3Root,
     eLHE,
     eLHEGZ,
     eROOT,
     eRivet,
+    eSharedMemory,
+    eHistograms,
     eNone,
   };
 
+  /** Collision to generate again with its seed (--regenerate) */
+  struct EventSeed {
+    int fCollision;
+    int fSeed;
+  };
+
+  /** Additional output written next to the main one (--sink mode[:file]) */
+  struct OutputSink {
+    EOutputMode fMode;
+    std::string fFileName;
+  };
+
   CRMCoptions(int argc, char** argv);
   virtual ~CRMCoptions() {}
 
@@ -31,6 +48,19 @@ class CRMCoptions {
   EOutputMode GetOutputMode() const { return fOutputMode; }
   std::string GetOutputTypeEnding() const;
   std::string GetOutputFileName() const;
+  bool IsOutputFileNameSet() const { return !fOutputFileName.empty(); }
+  const std::vector<OutputSink>& GetOutputSinks() const { return fOutputSinks; }
+  CRMCoptions ForOutputSink(const OutputSink& sink) const;
+
+  int GetShardEvents() const { return fShardEvents; }
+  long long GetShardBytes() const { return fShardBytes; }
+  int GetShmSlots() const { return fShmSlots; }
+  double GetShmTimeout() const { return fShmTimeout; }
+  int GetBlockEvents() const { return fBlockEvents; }
+  bool IsSharded() const { return fShardEvents > 0 || fShardBytes > 0; }
+  std::string GetShardFileName(const std::string& fileName,
+                               const std::string& ending,
+                               const int shard) const;
 
   const std::string GetRHICfRunType() const { return fRHICfRunType;}
   const std::string GetJobIndex() const { return fJobIndex;}
@@ -42,6 +72,17 @@ class CRMCoptions {
   bool IsTest() const { return fTest; }
   bool IsCSMode() const { return fCSMode; }
   int GetSeed() const { return fSeed; }
+  bool UseEventSeeds() const { return fEventSeeds; }
+  int GetEventSeed(const int collision) const;
+  bool IsSeedsOnly() const { return fSeedsOnly; }
+  bool IsReplay() const { return !fReplayFileName.empty(); }
+  const std::string& GetReplayFileName() const { return fReplayFileName; }
+  bool IsPileup() const { return !fPileupBankName.empty(); }
+  const std::string& GetPileupBankName() const { return fPileupBankName; }
+  double GetPileupMu() const { return fPileupMu; }
+  bool IsRegenerate() const { return !fRegenerate.empty(); }
+  const std::vector<EventSeed>& GetRegenerateEvents() const { return fRegenerate; }
+  /** Output type of the event record: -1 ROOT, 1 LHE, 0 otherwise */
   int GetTypout() const { return fTypout; }
   bool ProduceTables() const { return fProduceTables; }
   //std::string GetFilter() const { return fFilter; }
@@ -58,6 +99,10 @@ class CRMCoptions {
   const std::vector<std::string>& GetRivetSearch() const { return fRivetSearch;}
   const std::vector<std::string>& GetRivetPreloads() const { return fRivetPreloads;}
   const std::vector<std::string>& GetRivetAnalyses() const { return fRivetAnalyses;}
+  int GetRivetThreads() const { return fRivetThreads; }
+  const std::string& GetHistConfigName() const { return fHistConfigName; }
+  bool IsProfileStartup() const { return !fProfileStartupName.empty(); }
+  const std::string& GetProfileStartupName() const { return fProfileStartupName; }
 
  protected:
 
@@ -72,6 +117,15 @@ class CRMCoptions {
   int fTargetId;
   int fHEModel;
   int fTypout;
+  int fShardEvents;
+  long long fShardBytes;
+  int fShmSlots;
+  double fShmTimeout;
+  int fBlockEvents;
+  int fRivetThreads;
+  std::vector<std::string> fRootBranches;
+  std::string fRootPrecision;
+  bool fRootFinalOnly;
   double fProjectileMomentum;
   double fTargetMomentum;
   double fSqrts;
@@ -79,12 +133,21 @@ class CRMCoptions {
   std::string fOutputFileName;
   std::string fRHICfRunType;
   std::string fJobIndex;
+  std::string fReplayFileName;
+  std::string fHistConfigName;
+  std::string fProfileStartupName;
+  std::string fPileupBankName;
+  double fPileupMu;
   std::vector<std::string> fRivetAnalyses;
   std::vector<std::string> fRivetSearch;
   std::vector<std::string> fRivetPreloads;
+  std::vector<OutputSink> fOutputSinks;
+  std::vector<EventSeed> fRegenerate;
 
   bool fProduceTables;
   bool fSeedProvided;
+  bool fEventSeeds;
+  bool fSeedsOnly;
   //std::string fFilter;
   bool fTest;
   bool fCSMode;
@@ -93,6 +156,9 @@ class CRMCoptions {
 
   void CheckEnvironment();
   void ParseOptions(int argc, char** argv);
+  EOutputMode ParseOutputMode(const std::string& om) const;
+  static int TypoutFor(const EOutputMode mode);
+  bool HasOutputMode(const EOutputMode mode) const;
 
 };
 
@@ -0,0 +1,112 @@
+#include <CRMCpileup.h>
+
+#include <CRMCoptions.h>
+#include <CRMChepevt.h>
+
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+
+CRMCpileup::CRMCpileup(const CRMCoptions& cfg)
+  : fBankFileName(cfg.GetPileupBankName()),
+    fBank(CRMCreplay::Create(cfg.GetPileupBankName())),
+    fRandom(cfg.GetSeed()),
+    fNCollisions(cfg.GetPileupMu())
+{
+  if (!fBank)
+    throw runtime_error("!!! Cannot read pileup bank " + fBankFileName);
+  fVertexSpread.init(cfg.GetRHICfRunType());
+}
+
+
+void
+CRMCpileup::Mix()
+{
+  normal_distribution<double> gaus;
+  auto draw = [&](double mean, double sigma) { return mean + sigma * gaus(fRandom); };
+
+  // the signal collision is overwritten by reading the bank
+  fSignal = gCRMC_data;
+  fSignal.fNPileup = fNCollisions(fRandom);
+  fVertexSpread.draw(draw, fSignal.fVertex);
+  fEntries.clear();
+  Append(fSignal.fVertex);
+
+  for (int i = 0; i < fSignal.fNPileup; i++) {
+    double vertex[3];
+    fVertexSpread.draw(draw, vertex);
+    NextBankEvent();
+    Append(vertex);
+  }
+
+  gCRMC_data = fSignal;
+  int n = int(fEntries.size());
+  if (n > HepMC_HEPEVT_SIZE || n > int(CRMCdata::fMaxParticles)) {
+    cerr << " Event with pileup has more than " << HepMC_HEPEVT_SIZE
+         << " particles, truncated" << endl;
+    n = min(HepMC_HEPEVT_SIZE, int(CRMCdata::fMaxParticles));
+  }
+  for (int i = 0; i < n; i++) {
+    const Entry& e = fEntries[i];
+    hepevt_.isthep[i] = e.fStatus;
+    hepevt_.idhep[i] = e.fPdg;
+    for (int j = 0; j < 2; j++) {
+      // links out of a truncated record are dropped
+      hepevt_.jmohep[i][j] = (e.fMother[j] <= n ? e.fMother[j] : 0);
+      hepevt_.jdahep[i][j] = (e.fDaughter[j] <= n ? e.fDaughter[j] : 0);
+    }
+    for (int j = 0; j < 5; j++)
+      hepevt_.phep[i][j] = e.fP[j];
+    for (int j = 0; j < 4; j++)
+      hepevt_.vhep[i][j] = e.fV[j];
+
+    gCRMC_data.fPartId[i] = e.fPdg;
+    gCRMC_data.fPartPx[i] = e.fP[0];
+    gCRMC_data.fPartPy[i] = e.fP[1];
+    gCRMC_data.fPartPz[i] = e.fP[2];
+    gCRMC_data.fPartEnergy[i] = e.fP[3];
+    gCRMC_data.fPartMass[i] = e.fP[4];
+    gCRMC_data.fPartStatus[i] = e.fStatus;
+  }
+  hepevt_.nhep = n;
+  gCRMC_data.fNParticles = n;
+}
+
+
+void
+CRMCpileup::Append(const double vertex[3])
+{
+  // HEPEVT links are 1-based, 0 for none
+  const int offset = int(fEntries.size());
+  for (int i = 0; i < hepevt_.nhep; i++) {
+    Entry e;
+    e.fStatus = hepevt_.isthep[i];
+    e.fPdg = hepevt_.idhep[i];
+    for (int j = 0; j < 2; j++) {
+      e.fMother[j] = (hepevt_.jmohep[i][j] > 0 ? hepevt_.jmohep[i][j] + offset : 0);
+      e.fDaughter[j] = (hepevt_.jdahep[i][j] > 0 ? hepevt_.jdahep[i][j] + offset : 0);
+    }
+    for (int j = 0; j < 5; j++)
+      e.fP[j] = hepevt_.phep[i][j];
+    for (int j = 0; j < 3; j++)
+      e.fV[j] = hepevt_.vhep[i][j] + vertex[j];
+    e.fV[3] = hepevt_.vhep[i][3];
+    fEntries.push_back(e);
+  }
+}
+
+
+void
+CRMCpileup::NextBankEvent()
+{
+  if (fBank->Next())
+    return;
+
+  // the bank is reused from its start
+  cout << " ==[crmc]==> End of pileup bank " << fBankFileName << ", starting again" << endl;
+  fBank.reset(CRMCreplay::Create(fBankFileName));
+  if (!fBank || !fBank->Next())
+    throw runtime_error("!!! No event in pileup bank " + fBankFileName);
+}
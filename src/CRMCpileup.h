@@ -0,0 +1,58 @@
+#ifndef _CRMCpileup_h_
+#define _CRMCpileup_h_
+
+#include <CRMCinterface.h>
+#include <CRMCreplay.h>
+#include <CRMCvertex.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class CRMCoptions;
+
+/**
+ * Overlays pileup on every collision (--pileup-bank, --pileup-mu): a
+ * Poisson distributed number of minimum-bias collisions is read from a
+ * bank file written by an earlier run (any format of --replay) and
+ * appended to the event in HEPEVT and gCRMC_data.
+ *
+ * Every collision, the signal one included, is placed at its own
+ * vertex drawn from the beam spot of the RHICf run type.  The signal
+ * vertex is kept in gCRMC_data.fVertex, the event information
+ * (impact parameter, process, ...) is the one of the signal collision.
+ */
+class CRMCpileup {
+
+ public:
+  CRMCpileup(const CRMCoptions& cfg);
+
+  /** Overlay the pileup on the event just generated */
+  void Mix();
+
+ private:
+  struct Entry {
+    int fStatus;
+    int fPdg;
+    int fMother[2];
+    int fDaughter[2];
+    double fP[5];
+    double fV[4];
+  };
+
+  /** Append the collision in HEPEVT to fEntries, moved to vertex */
+  void Append(const double vertex[3]);
+  void NextBankEvent();
+
+  std::string fBankFileName;
+  std::unique_ptr<CRMCreplay> fBank;
+  CRMCvertex fVertexSpread;
+  std::mt19937 fRandom;
+  std::poisson_distribution<int> fNCollisions;
+  std::vector<Entry> fEntries;
+  CRMCdata fSignal;
+};
+
+
+#endif
@@ -0,0 +1,222 @@
+#include <CRMCprefetch.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+  /** Value of -x V, -xV, --long V or --long=V, else "" */
+  string
+  ArgValue(const int argc, char** argv, const string& shortName, const string& longName)
+  {
+    string value;
+    for (int i = 1; i < argc; ++i) {
+      const string arg = argv[i];
+      if (arg == shortName || arg == longName) {
+        if (i + 1 < argc)
+          value = argv[i + 1];
+      }
+      else if (arg.compare(0, longName.size() + 1, longName + "=") == 0)
+        value = arg.substr(longName.size() + 1);
+      else if (arg.size() > shortName.size() && arg.compare(0, shortName.size(), shortName) == 0)
+        value = arg.substr(shortName.size());
+    }
+    return value;
+  }
+
+}
+
+
+CRMCprefetch&
+CRMCprefetch::Get()
+{
+  static CRMCprefetch prefetch;
+  return prefetch;
+}
+
+
+CRMCprefetch::CRMCprefetch() :
+  fStop(false),
+  fDone(false),
+  fMB(0),
+  fSeconds(0)
+{
+}
+
+
+CRMCprefetch::~CRMCprefetch()
+{
+  // e.g. exit() during the initialization
+  fStop = true;
+  if (fReader.joinable())
+    fReader.join();
+}
+
+
+void
+CRMCprefetch::Start(const int argc, char** argv)
+{
+  const char* env = getenv("CRMC_PREFETCH");
+  if ((env && string(env) == "off") || fReader.joinable())
+    return;
+
+  // the defaults of CRMCoptions
+  const string model = ArgValue(argc, argv, "-m", "--model");
+  string paramFile = ArgValue(argc, argv, "-c", "--config");
+  if (paramFile.empty())
+    paramFile = "crmc.param";
+
+  fFiles = TableNames(paramFile, model.empty() ? 0 : atoi(model.c_str()));
+  if (fFiles.empty())
+    return;
+
+  // the kernel starts reading at once where it can, the thread makes sure
+  for (size_t i = 0; i < fFiles.size(); ++i) {
+    const int fd = open(fFiles[i].c_str(), O_RDONLY);
+    if (fd < 0)
+      continue;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+  }
+  fReader = thread(&CRMCprefetch::Read, this);
+}
+
+
+void
+CRMCprefetch::Stop()
+{
+  if (!fReader.joinable())
+    return;
+  fStop = true;
+  fReader.join();
+  cout << " ==[crmc]==> prefetched " << fFiles.size() << " table" << (fFiles.size() > 1 ? "s" : "")
+       << " (" << int(fMB) << " MB in " << int(fSeconds * 10) / 10. << " s"
+       << (fDone ? "" : ", stopped") << ")" << endl;
+}
+
+
+vector<string>
+CRMCprefetch::TableNames(const string& paramFile, const int model)
+{
+  // parameter file lines naming the tables read by each model
+  const char* epos[] = { "fname initl", "fname iniev", "fname inirj", "fname inics",
+                         "fname inihy", 0 };
+  const char* qgsjet01[] = { "fqgsjet dat", "fqgsjet ncs", 0 };
+  const char* qgsjetII04[] = { "fqgsjetII dat", "fqgsjetII ncs", 0 };
+  const char* qgsjetII03[] = { "fqgsjetII03 dat", "fqgsjetII03 ncs", 0 };
+  const char* dpmjet[] = { "fdpmjet dat", "fdpmjet pho", 0 };
+  const char* qgsjetIII[] = { "fqgsjetIII dat", "fqgsjetIII ncs", 0 };
+  const char** keys = 0;
+  switch (model) {
+  case 0:
+  case 1:  keys = epos; break;
+  case 2:  keys = qgsjet01; break;
+  case 7:  keys = qgsjetII04; break;
+  case 11: keys = qgsjetII03; break;
+  case 12: keys = dpmjet; break;
+  case 13: keys = qgsjetIII; break;
+  default: return vector<string>();
+  }
+
+  vector<string> files;
+  ifstream in(paramFile.c_str());
+  string line;
+  while (getline(in, line)) {
+    const size_t comment = line.find('!');
+    if (comment != string::npos)
+      line.erase(comment);
+    istringstream words(line);
+    string command, type, name;
+    if (!(words >> command))
+      continue;
+    if (command == "EndEposInput")
+      break;
+    if (!(words >> type >> name))
+      continue;
+    const string key = command + " " + type;
+    bool wanted = false;
+    for (int i = 0; keys[i]; ++i)
+      wanted = wanted || key == keys[i];
+    struct stat st;
+    if (wanted && stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode) && !HasCache(name))
+      files.push_back(name);
+  }
+  return files;
+}
+
+
+bool
+CRMCprefetch::HasCache(const string& fileName)
+{
+  // directory and file names as in TabCache, <table>.<key>.tab
+  string directory;
+  const char* dir = getenv("CRMC_TABCACHE");
+  if (dir && string(dir) == "off")
+    return false;
+  if (dir && *dir)
+    directory = dir;
+  else if (getenv("HOME"))
+    directory = string(getenv("HOME")) + "/.cache/crmc";
+  else
+    return false;
+
+  struct stat table;
+  if (stat(fileName.c_str(), &table) != 0)
+    return false;
+  const size_t slash = fileName.rfind('/');
+  const string prefix = (slash == string::npos ? fileName : fileName.substr(slash + 1)) + ".";
+
+  bool found = false;
+  DIR* d = opendir(directory.c_str());
+  if (!d)
+    return false;
+  while (const dirent* entry = readdir(d)) {
+    const string name = entry->d_name;
+    if (name.size() != prefix.size() + 20 || name.compare(0, prefix.size(), prefix) != 0
+        || name.compare(name.size() - 4, 4, ".tab") != 0)
+      continue;
+    struct stat cache;
+    if (stat((directory + "/" + name).c_str(), &cache) == 0 && cache.st_mtime >= table.st_mtime) {
+      found = true;
+      break;
+    }
+  }
+  closedir(d);
+  return found;
+}
+
+
+void
+CRMCprefetch::Read()
+{
+  const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  const size_t bufferSize = 1 << 20;
+  char* buffer = new char[bufferSize];
+  size_t bytes = 0;
+  for (size_t i = 0; i < fFiles.size() && !fStop; ++i) {
+    const int fd = open(fFiles[i].c_str(), O_RDONLY);
+    if (fd < 0)
+      continue;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ssize_t n = 0;
+    while (!fStop && (n = read(fd, buffer, bufferSize)) > 0)
+      bytes += n;
+    close(fd);
+  }
+  delete[] buffer;
+  fDone = !fStop;
+  fMB = bytes / 1048576.;
+  fSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,51 @@
+#ifndef _CRMCprefetch_h_
+#define _CRMCprefetch_h_
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Reads the tables of the chosen model into the page cache in the
+ * background, while the options are parsed, the model library is
+ * loaded and the model parses the tables read before.
+ *
+ * Started first thing in main: the model (-m) and the parameter file
+ * (-c) are taken from the command line before the options are parsed,
+ * the table paths from the parameter file (fname initl, fqgsjetIII dat,
+ * ...).  All tables get posix_fadvise(WILLNEED), then a thread reads
+ * them in the order of the parameter file.  Tables with a binary cache
+ * (src/tabcache/TabCache.h) newer than themselves are not read by the
+ * model and skipped; the cache is read when it is loaded.
+ *
+ * CRMC_PREFETCH=off disables it.
+ */
+class CRMCprefetch {
+
+ public:
+  static CRMCprefetch& Get();
+
+  /** Starts reading the tables named in the parameter file for the model in argv */
+  void Start(const int argc, char** argv);
+  /** Ends the reading, the model has read its tables by now */
+  void Stop();
+
+ private:
+  CRMCprefetch();
+  ~CRMCprefetch();
+
+  static std::vector<std::string> TableNames(const std::string& paramFile, const int model);
+  static bool HasCache(const std::string& fileName);
+  void Read();
+
+  std::vector<std::string> fFiles;
+  std::thread fReader;
+  std::atomic<bool> fStop;
+  std::atomic<bool> fDone;
+  double fMB;
+  double fSeconds;
+};
+
+
+#endif
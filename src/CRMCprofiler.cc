@@ -0,0 +1,174 @@
+#include <CRMCprofiler.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/resource.h>
+
+using namespace std;
+
+
+namespace {
+
+  string
+  JSONString(const string& s)
+  {
+    ostringstream out;
+    out << '"';
+    for (size_t i = 0; i < s.size(); ++i) {
+      const unsigned char c = s[i];
+      if (c == '"' || c == '\\')
+        out << '\\' << c;
+      else if (c < 0x20) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", c);
+        out << buf;
+      }
+      else
+        out << c;
+    }
+    out << '"';
+    return out.str();
+  }
+
+}
+
+
+CRMCprofiler&
+CRMCprofiler::Get()
+{
+  static CRMCprofiler profiler;
+  return profiler;
+}
+
+
+CRMCprofiler::CRMCprofiler() :
+  fStart(Clock::now()),
+  fPhaseStart(fStart)
+{
+}
+
+
+double
+CRMCprofiler::PeakRSS()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return usage.ru_maxrss / 1024.; // kB on Linux
+}
+
+
+double
+CRMCprofiler::HugePagesMB()
+{
+  ifstream in("/proc/self/smaps_rollup");
+  string name;
+  double kB = 0;
+  while (in >> name) {
+    if (name == "AnonHugePages:" && in >> kB)
+      return kB / 1024.;
+    in.ignore(1024, '\n');
+  }
+  return 0;
+}
+
+
+void
+CRMCprofiler::Phase(const string& name)
+{
+  Stop();
+  fCurrent = name;
+  fPhaseStart = Clock::now();
+}
+
+
+void
+CRMCprofiler::Stop()
+{
+  if (fCurrent.empty())
+    return;
+  const chrono::duration<double> seconds = Clock::now() - fPhaseStart;
+  const Entry e = { fCurrent, seconds.count(), PeakRSS(), -1, false };
+  fPhases.push_back(e);
+  fCurrent.clear();
+}
+
+
+void
+CRMCprofiler::AddTable(const string& fileName, const double seconds, const double peakRSS,
+                       const bool fromCache)
+{
+  const Entry e = { fileName, seconds, peakRSS, int(fPhases.size()), fromCache };
+  fTables.push_back(e);
+}
+
+
+void
+CRMCprofiler::Print(ostream& out)
+  const
+{
+  const ios::fmtflags flags = out.flags();
+  const streamsize precision = out.precision();
+  double total = 0;
+  out << "\n ==[crmc]==> start-up profile (wall time, peak RSS)\n";
+  for (size_t i = 0; i < fPhases.size(); ++i) {
+    const Entry& p = fPhases[i];
+    total += p.fSeconds;
+    out << "  " << left << setw(44) << p.fName << right << fixed << setprecision(3)
+        << setw(10) << p.fSeconds << " s " << setprecision(1) << setw(9) << p.fPeakRSS
+        << " MB\n";
+    for (size_t j = 0; j < fTables.size(); ++j) {
+      const Entry& t = fTables[j];
+      if (t.fPhase != int(i))
+        continue;
+      const size_t slash = t.fName.rfind('/');
+      const string name = (t.fFromCache ? "cache " : "text  ")
+                          + (slash == string::npos ? t.fName : t.fName.substr(slash + 1));
+      out << "    " << left << setw(42) << name << right << setprecision(3) << setw(10)
+          << t.fSeconds << " s " << setprecision(1) << setw(9) << t.fPeakRSS << " MB\n";
+    }
+  }
+  out << "  " << left << setw(44) << "total" << right << setprecision(3) << setw(10) << total
+      << " s\n";
+  const double hugePages = HugePagesMB();
+  if (hugePages > 0)
+    out << "  " << left << setw(44) << "in huge pages" << right << setprecision(1) << setw(22)
+        << hugePages << " MB\n";
+  out << endl;
+  out.flags(flags);
+  out.precision(precision);
+}
+
+
+bool
+CRMCprofiler::WriteJSON(const string& fileName)
+  const
+{
+  ofstream out(fileName.c_str());
+  if (!out.is_open())
+    return false;
+
+  double total = 0;
+  out << "{\n  \"phases\": [";
+  for (size_t i = 0; i < fPhases.size(); ++i) {
+    const Entry& p = fPhases[i];
+    total += p.fSeconds;
+    out << (i ? ",\n" : "\n") << "    {\"name\": " << JSONString(p.fName)
+        << ", \"seconds\": " << p.fSeconds << ", \"peak_rss_mb\": " << p.fPeakRSS << "}";
+  }
+  out << "\n  ],\n  \"tables\": [";
+  for (size_t i = 0; i < fTables.size(); ++i) {
+    const Entry& t = fTables[i];
+    const string phase = (t.fPhase < int(fPhases.size()) ? fPhases[t.fPhase].fName : fCurrent);
+    out << (i ? ",\n" : "\n") << "    {\"file\": " << JSONString(t.fName)
+        << ", \"source\": \"" << (t.fFromCache ? "cache" : "text") << "\""
+        << ", \"phase\": " << JSONString(phase) << ", \"seconds\": " << t.fSeconds
+        << ", \"peak_rss_mb\": " << t.fPeakRSS << "}";
+  }
+  out << "\n  ],\n  \"total_seconds\": " << total
+      << ",\n  \"huge_pages_mb\": " << HugePagesMB() << "\n}\n";
+  return out.good();
+}
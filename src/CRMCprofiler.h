@@ -0,0 +1,59 @@
+#ifndef _CRMCprofiler_h_
+#define _CRMCprofiler_h_
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Start-up timeline (--profile-startup): wall time and peak resident
+ * size at the end of every phase up to the first event, and of every
+ * table read by the models (from src/tabcache/TabCache).
+ *
+ * The phases are always recorded, this costs a clock reading each; they
+ * are only printed and written as JSON with --profile-startup.
+ */
+class CRMCprofiler {
+
+ public:
+  static CRMCprofiler& Get();
+
+  /** Ends the current phase, if any, and starts the next one */
+  void Phase(const std::string& name);
+  /** Ends the current phase */
+  void Stop();
+  /** A table read during the current phase (fromCache: binary cache, else text) */
+  void AddTable(const std::string& fileName, const double seconds, const double peakRSS,
+                const bool fromCache);
+
+  void Print(std::ostream& out) const;
+  bool WriteJSON(const std::string& fileName) const;
+
+  /** Peak resident set size of the process so far, in MB */
+  static double PeakRSS();
+  /** Memory in transparent huge pages now (e.g. with CRMC_HUGEPAGES=on), in MB */
+  static double HugePagesMB();
+
+ private:
+  CRMCprofiler();
+
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry {
+    std::string fName;
+    double fSeconds;
+    double fPeakRSS;
+    int fPhase;      // tables: index of the phase, -1 for phases
+    bool fFromCache;
+  };
+
+  Clock::time_point fStart;
+  Clock::time_point fPhaseStart;
+  std::string fCurrent;
+  std::vector<Entry> fPhases;
+  std::vector<Entry> fTables;
+};
+
+
+#endif
@@ -0,0 +1,70 @@
+// -*- mode: C++ -*-
+/**
+ * @file      src/CRMCqueue.h
+ *
+ * @brief  Bounded blocking queue to hand events to worker threads
+ */
+#ifndef CRMCqueue_h
+#define CRMCqueue_h
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * First-in first-out queue of at most `capacity` items shared
+ * between threads.  push() waits while the queue is full, which
+ * throttles the producer to the speed of the consumers, and pop()
+ * waits while it is empty.  After close() no more items are accepted
+ * and pop() returns false once the remaining items are taken.
+ *
+ * @ingroup utils
+ */
+template <typename T>
+class CRMCqueue
+{
+public:
+  explicit CRMCqueue(std::size_t capacity) : _capacity(capacity), _closed(false) {}
+
+  /** Add an item, false if the queue was closed */
+  bool push(T item)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notFull.wait(lock, [this] { return _closed or _items.size() < _capacity; });
+    if (_closed) return false;
+    _items.push_back(std::move(item));
+    _notEmpty.notify_one();
+    return true;
+  }
+  /** Take the oldest item, false if the queue is closed and empty */
+  bool pop(T& item)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notEmpty.wait(lock, [this] { return _closed or not _items.empty(); });
+    if (_items.empty()) return false;
+    item = std::move(_items.front());
+    _items.pop_front();
+    _notFull.notify_one();
+    return true;
+  }
+  /** No more items will be pushed, wakes up all waiting threads */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+    _notEmpty.notify_all();
+    _notFull.notify_all();
+  }
+
+private:
+  std::size_t _capacity;
+  bool _closed;
+  std::deque<T> _items;
+  std::mutex _mutex;
+  std::condition_variable _notEmpty;
+  std::condition_variable _notFull;
+};
+#endif
+//
+// EOF
+//
@@ -0,0 +1,363 @@
+#include <CRMCreplay.h>
+
+#include <CRMCinterface.h>
+#include <CRMChepevt.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#ifdef WITH_HEPMC3
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/GenHeavyIon.h>
+#include <HepMC3/GenCrossSection.h>
+#include <HepMC3/Attribute.h>
+#include <HepMC3/ReaderAscii.h>
+#include <HepMC3/ReaderAsciiHepMC2.h>
+
+#include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#endif
+
+#ifdef WITH_ROOT
+#include "TFile.h"
+#include "TTree.h"
+#include "TClonesArray.h"
+#include "TParticle.h"
+#endif
+
+using namespace std;
+
+
+namespace {
+
+  bool EndsWith(const string& name, const string& ending)
+  {
+    return name.size() >= ending.size()
+      && name.compare(name.size() - ending.size(), ending.size(), ending) == 0;
+  }
+
+#ifdef WITH_HEPMC3
+  namespace io = boost::iostreams;
+
+  io::filtering_istream* OpenInput(const string& fileName)
+  {
+    io::filtering_istream* in = new io::filtering_istream();
+    if (EndsWith(fileName, ".gz"))
+      in->push(io::gzip_decompressor());
+    in->push(io::file_descriptor_source(fileName));
+    return in;
+  }
+
+
+  /** HepMC2 or HepMC3 ASCII events (-o hepmc, hepmc3file and their gzip variants) */
+  class CRMCreplayHepMC : public CRMCreplay {
+
+  public:
+    CRMCreplayHepMC(const string& fileName)
+    {
+      // the listing header tells the format, the reader gets a fresh stream
+      bool isHepMC2 = false;
+      {
+        unique_ptr<io::filtering_istream> probe(OpenInput(fileName));
+        string line;
+        while (getline(*probe, line)) {
+          if (line.find("HepMC::IO_GenEvent") == 0) { isHepMC2 = true; break; }
+          if (line.find("HepMC::Asciiv3") == 0) break;
+        }
+      }
+      fIn.reset(OpenInput(fileName));
+      if (isHepMC2)
+        fReader.reset(new HepMC3::ReaderAsciiHepMC2(*fIn));
+      else
+        fReader.reset(new HepMC3::ReaderAscii(*fIn));
+    }
+
+    bool Next() override
+    {
+      if (!fReader->read_event(fEvent) || fReader->failed())
+        return false;
+
+      Clear();
+      // ids are the positions in particles(), starting at 1 like HEPEVT
+      for (const auto& p : fEvent.particles()) {
+        int mother[2] = { 0, 0 };
+        int daughter[2] = { 0, 0 };
+        double pos[4] = { 0, 0, 0, 0 };
+        auto production = p->production_vertex();
+        if (production) {
+          const auto& in = production->particles_in();
+          if (!in.empty()) {
+            mother[0] = in.front()->id();
+            if (in.size() > 1) mother[1] = in.back()->id();
+          }
+          pos[0] = production->position().x();
+          pos[1] = production->position().y();
+          pos[2] = production->position().z();
+          pos[3] = production->position().t();
+        }
+        auto end = p->end_vertex();
+        if (end && !end->particles_out().empty()) {
+          daughter[0] = end->particles_out().front()->id();
+          daughter[1] = end->particles_out().back()->id();
+        }
+        const auto& mom = p->momentum();
+        if (!Add(p->status(), p->pdg_id(), mother[0], mother[1], daughter[0], daughter[1],
+                 mom.px(), mom.py(), mom.pz(), mom.e(), p->generated_mass(),
+                 pos[0], pos[1], pos[2], pos[3])) {
+          cerr << " Replayed event has more than " << HepMC_HEPEVT_SIZE
+               << " particles, truncated" << endl;
+          break;
+        }
+      }
+
+      auto ion = fEvent.heavy_ion();
+      if (ion) {
+        gCRMC_data.kohevt = ion->Ncoll_hard;
+        gCRMC_data.npjevt = ion->Npart_proj;
+        gCRMC_data.ntgevt = ion->Npart_targ;
+        gCRMC_data.kolevt = ion->Ncoll;
+        gCRMC_data.ng1evt = ion->N_Nwounded_collisions;
+        gCRMC_data.ng2evt = ion->Nwounded_N_collisions;
+        gCRMC_data.nglevt = ion->Nwounded_Nwounded_collisions;
+        gCRMC_data.bimevt = ion->impact_parameter;
+        gCRMC_data.phievt = ion->event_plane_angle;
+        gCRMC_data.npnevt = ion->Nspec_proj_n;
+        gCRMC_data.ntnevt = ion->Nspec_targ_n;
+        gCRMC_data.nppevt = ion->Nspec_proj_p;
+        gCRMC_data.ntpevt = ion->Nspec_targ_p;
+        gCRMC_data.fImpactParameter = ion->impact_parameter;
+      }
+      auto xsec = fEvent.cross_section();
+      if (xsec) {
+        // written in pb, see CRMChepmc3
+        gCRMC_data.sigine = xsec->xsec() / 1e9;
+        gCRMC_data.sigineaa = gCRMC_data.sigine;
+      }
+      // only the HepMC2 files keep the process
+      auto process = fEvent.attribute<HepMC3::IntAttribute>("signal_process_id");
+      if (process)
+        gCRMC_data.typevt = TypeFromSignalProcess(process->value());
+      return true;
+    }
+
+  private:
+    unique_ptr<io::filtering_istream> fIn;
+    unique_ptr<HepMC3::Reader> fReader;
+    HepMC3::GenEvent fEvent;
+  };
+#endif
+
+
+#ifdef WITH_ROOT
+  /** RHICf trees (-o hepmc3, hepmc3gz) */
+  class CRMCreplayRHICf : public CRMCreplay {
+
+  public:
+    CRMCreplayRHICf(const string& fileName)
+      : fFile(TFile::Open(fileName.c_str())),
+        fEventTree(0),
+        fSummaryTree(0),
+        fParticles(0),
+        fProcessID(-1),
+        fImpactParameter(-1),
+        fNPartProj(-1),
+        fNPartTarg(-1),
+        fEntry(0)
+    {
+      fVertex[0] = fVertex[1] = fVertex[2] = 0;
+      if (!fFile || fFile->IsZombie())
+        return;
+      fFile->GetObject("Event", fEventTree);
+      if (!fEventTree)
+        return;
+      fEventTree->SetBranchAddress("Particles", &fParticles);
+      fEventTree->SetBranchAddress("ProcessID", &fProcessID);
+
+      // the stored vertices include the smearing of the collision vertex,
+      // removed again if it is known so that the output smears anew
+      fFile->GetObject("Summary", fSummaryTree);
+      if (fSummaryTree && fSummaryTree->GetEntries() == fEventTree->GetEntries()) {
+        fSummaryTree->SetBranchAddress("ImpactParameter", &fImpactParameter);
+        fSummaryTree->SetBranchAddress("NPartProj", &fNPartProj);
+        fSummaryTree->SetBranchAddress("NPartTarg", &fNPartTarg);
+        fSummaryTree->SetBranchAddress("Vertex", fVertex);
+      }
+      else {
+        fSummaryTree = 0;
+        cerr << " No Summary tree in " << fileName
+             << ", vertices are replayed with their original smearing" << endl;
+      }
+    }
+
+    ~CRMCreplayRHICf() override
+    {
+      delete fFile;
+    }
+
+    bool IsOpen() const { return fEventTree != 0; }
+
+    bool Next() override
+    {
+      if (fEntry >= fEventTree->GetEntries())
+        return false;
+      fEventTree->GetEntry(fEntry);
+      if (fSummaryTree)
+        fSummaryTree->GetEntry(fEntry);
+      fEntry++;
+
+      Clear();
+      // HEPEVT indices (from 1) of the beams, status 4
+      int beam[2] = { 0, 0 };
+      int nBeams = 0;
+      for (int i = 0; i < fParticles->GetEntriesFast() && nBeams < 2; i++)
+        if (((const TParticle*)fParticles->At(i))->GetStatusCode() == 4)
+          beam[nBeams++] = i + 1;
+
+      // mothers and daughters are stored as HEPEVT indices, -1 (or 0) if
+      // none.  Only single mothers are stored: the particles made by both
+      // beams are attached to them again, else the conversion to HepMC
+      // (add_tree from the beams) would drop them
+      for (int i = 0; i < fParticles->GetEntriesFast(); i++) {
+        const TParticle* p = (const TParticle*)fParticles->At(i);
+        int mother1 = max(p->GetFirstMother(), 0);
+        int mother2 = max(p->GetLastMother(), 0);
+        if (mother1 == 0 && nBeams == 2 && p->GetStatusCode() != 4) {
+          mother1 = beam[0];
+          mother2 = beam[1];
+        }
+        if (!Add(p->GetStatusCode(), p->GetPdgCode(), mother1, mother2,
+                 max(p->GetFirstDaughter(), 0), max(p->GetLastDaughter(), 0),
+                 p->Px(), p->Py(), p->Pz(), p->Energy(), p->GetCalcMass(),
+                 p->Vx() - fVertex[0], p->Vy() - fVertex[1], p->Vz() - fVertex[2], p->T())) {
+          cerr << " Replayed event has more than " << HepMC_HEPEVT_SIZE
+               << " particles, truncated" << endl;
+          break;
+        }
+      }
+      gCRMC_data.typevt = fProcessID;
+      gCRMC_data.bimevt = fImpactParameter;
+      gCRMC_data.fImpactParameter = fImpactParameter;
+      gCRMC_data.npjevt = fNPartProj;
+      gCRMC_data.ntgevt = fNPartTarg;
+      return true;
+    }
+
+  private:
+    TFile* fFile;
+    TTree* fEventTree;
+    TTree* fSummaryTree;
+    TClonesArray* fParticles;
+    Int_t fProcessID;
+    Float_t fImpactParameter;
+    Int_t fNPartProj;
+    Int_t fNPartTarg;
+    Float_t fVertex[3];
+    Long64_t fEntry;
+  };
+#endif
+
+}
+
+
+CRMCreplay*
+CRMCreplay::Create(const string& fileName)
+{
+  if (EndsWith(fileName, ".root") && !EndsWith(fileName, ".hepmc.root")) {
+#ifdef WITH_ROOT
+    CRMCreplayRHICf* replay = new CRMCreplayRHICf(fileName);
+    if (replay->IsOpen())
+      return replay;
+    cerr << " No RHICf Event tree in " << fileName << endl;
+    delete replay;
+#endif
+    return 0;
+  }
+#ifdef WITH_HEPMC3
+  if (EndsWith(fileName, ".hepmc") || EndsWith(fileName, ".hepmc.gz"))
+    return new CRMCreplayHepMC(fileName);
+#endif
+  return 0;
+}
+
+
+void
+CRMCreplay::Clear()
+{
+  // unknown quantities stay unset (-1) as in CRMCdata
+  gCRMC_data.Clean();
+  gCRMC_data.fImpactParameter = -1;
+  gCRMC_data.sigine = gCRMC_data.sigineaa = -1;
+  gCRMC_data.npjevt = gCRMC_data.ntgevt = gCRMC_data.kolevt = gCRMC_data.kohevt = -1;
+  gCRMC_data.npnevt = gCRMC_data.ntnevt = gCRMC_data.nppevt = gCRMC_data.ntpevt = -1;
+  gCRMC_data.nglevt = gCRMC_data.ng1evt = gCRMC_data.ng2evt = -1;
+  gCRMC_data.bimevt = gCRMC_data.phievt = -1;
+  gCRMC_data.typevt = -1;
+  gCRMC_data.fEventSeed = 0;
+  gCRMC_data.fNPileup = -1;
+
+  hepevt_.nevhep++;
+  hepevt_.nhep = 0;
+}
+
+
+bool
+CRMCreplay::Add(const int status, const int pdg,
+                const int mother1, const int mother2,
+                const int daughter1, const int daughter2,
+                const double px, const double py, const double pz,
+                const double e, const double m,
+                const double x, const double y, const double z, const double t)
+{
+  const int i = hepevt_.nhep;
+  if (i >= HepMC_HEPEVT_SIZE || i >= int(CRMCdata::fMaxParticles))
+    return false;
+
+  hepevt_.isthep[i] = status;
+  hepevt_.idhep[i] = pdg;
+  hepevt_.jmohep[i][0] = mother1;
+  hepevt_.jmohep[i][1] = mother2;
+  hepevt_.jdahep[i][0] = daughter1;
+  hepevt_.jdahep[i][1] = daughter2;
+  hepevt_.phep[i][0] = px;
+  hepevt_.phep[i][1] = py;
+  hepevt_.phep[i][2] = pz;
+  hepevt_.phep[i][3] = e;
+  hepevt_.phep[i][4] = m;
+  hepevt_.vhep[i][0] = x;
+  hepevt_.vhep[i][1] = y;
+  hepevt_.vhep[i][2] = z;
+  hepevt_.vhep[i][3] = t;
+  hepevt_.nhep = i + 1;
+
+  gCRMC_data.fPartId[i] = pdg;
+  gCRMC_data.fPartPx[i] = px;
+  gCRMC_data.fPartPy[i] = py;
+  gCRMC_data.fPartPz[i] = pz;
+  gCRMC_data.fPartEnergy[i] = e;
+  gCRMC_data.fPartMass[i] = m;
+  gCRMC_data.fPartStatus[i] = status;
+  gCRMC_data.fNParticles = i + 1;
+  return true;
+}
+
+
+int
+CRMCreplay::TypeFromSignalProcess(const int id)
+{
+  // not unique, the EPOS core and pion exchange variants are lost
+  switch (id) {
+  case 91: return 0;  // elastic
+  case 95: return 1;  // ND
+  case 96: return -1; // ND with core
+  case 94: return 2;  // DD
+  case 97: return 3;  // CD
+  case 92: return 4;  // SD (proj excit.)
+  case 93: return -4; // SD (targ excit.)
+  case 98: return 11; // pion exchange ND
+  default: return -1; // unknown
+  }
+}
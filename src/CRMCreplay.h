@@ -0,0 +1,44 @@
+#ifndef _CRMCreplay_h_
+#define _CRMCreplay_h_
+
+#include <string>
+
+/**
+ * Reads the events of an earlier run back into the HEPEVT common
+ * block and gCRMC_data (--replay), so that they go through the output
+ * policies and the RHICf acceptance again without being generated.
+ *
+ * Readers exist for HepMC2 and HepMC3 ASCII files (also gzip
+ * compressed, needs HepMC3) and for the RHICf ROOT trees (needs ROOT).
+ */
+class CRMCreplay {
+
+ public:
+  virtual ~CRMCreplay() {}
+
+  /** Read the next event, false at the end of the input */
+  virtual bool Next() = 0;
+
+  /** Reader for the given file, 0 if its format is not supported by this build */
+  static CRMCreplay* Create(const std::string& fileName);
+
+ protected:
+  /** Start a new event, all event information is reset */
+  static void Clear();
+  /**
+   * Append a particle to HEPEVT and gCRMC_data. Mothers and daughters
+   * are 1-based HEPEVT indices, 0 if none. Returns false if the record
+   * is full.
+   */
+  static bool Add(const int status, const int pdg,
+                  const int mother1, const int mother2,
+                  const int daughter1, const int daughter2,
+                  const double px, const double py, const double pz,
+                  const double e, const double m,
+                  const double x, const double y, const double z, const double t);
+  /** EPOS event type from a HepMC2 signal process id (see OutputPolicyHepMC) */
+  static int TypeFromSignalProcess(const int id);
+};
+
+
+#endif
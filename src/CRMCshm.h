@@ -0,0 +1,113 @@
+#ifndef _CRMCshm_h_
+#define _CRMCshm_h_
+
+#include <CRMCconfig.h>
+
+#include <atomic>
+#include <cerrno>
+#include <stdint.h>
+
+#include <signal.h>
+#include <time.h>
+
+/**
+ * Memory layout of the shared-memory event ring written by
+ * OutputPolicySharedMemory (-o shm) and read with CRMCshmReader.
+ *
+ * The segment starts with a CRMCshmHeader followed by fNSlots
+ * CRMCshmSlot. There is one producer (crmc) and one consumer: the
+ * producer only moves fWriteIndex, the consumer only fReadIndex, so
+ * no lock is needed. Slot i % fNSlots belongs to the consumer while
+ * fReadIndex <= i < fWriteIndex and to the producer otherwise.
+ *
+ * The particle list is the one of the ROOT output (CRMCdata stored
+ * for output type -1: the nucleons are the beam particles, there are
+ * no beam nuclei), also next to HepMC sinks; a slot holds
+ * HepMC_HEPEVT_SIZE particles, the producer and the consumer must be
+ * built with the same size.
+ *
+ * Both sides store their process id, so that the other one stops
+ * waiting when it has died instead of hanging.
+ */
+
+namespace CRMCshm {
+
+  const uint32_t kMagic = 0x434d5243; // "CRMC"
+  const uint32_t kVersion = 2;
+  const uint32_t kMaxParticles = HepMC_HEPEVT_SIZE; // same as CRMCdata::fMaxParticles
+
+  struct CRMCshmHeader {
+    std::atomic<uint32_t> fMagic; // set last by the producer, once the header is valid
+    uint32_t fVersion;
+    uint32_t fNSlots;
+    uint32_t fMaxParticles;
+    uint64_t fSlotSize;
+
+    // run information
+    int32_t fSeed;
+    int32_t fHEModel;
+    int32_t fProjectileId;
+    int32_t fTargetId;
+    double fProjectileMomentum;
+    double fTargetMomentum;
+    double fSqrts;
+
+    std::atomic<uint64_t> fWriteIndex; // next event the producer writes
+    std::atomic<uint64_t> fReadIndex;  // next event the consumer reads
+    std::atomic<uint32_t> fClosed;     // producer finished, no more events
+
+    int32_t fProducerPid;
+    std::atomic<int32_t> fConsumerPid; // 0 while no consumer is attached
+  };
+
+  struct CRMCshmSlot {
+    int32_t fEventNumber;
+    int32_t fTypevt;
+    int32_t fNpjevt;
+    int32_t fNtgevt;
+    int32_t fKolevt;
+    int32_t fNParticles;
+    double fImpactParameter;
+    double fSigmaInel;   // h-p inelastic cross section in mb
+    double fSigmaInelAA; // h-A or A-A inelastic cross section in mb
+
+    int32_t fPartId[kMaxParticles];
+    int32_t fPartStatus[kMaxParticles];
+    double fPartPx[kMaxParticles];
+    double fPartPy[kMaxParticles];
+    double fPartPz[kMaxParticles];
+    double fPartEnergy[kMaxParticles];
+    double fPartMass[kMaxParticles];
+  };
+
+  inline uint64_t SegmentSize(const uint32_t nSlots)
+  {
+    return sizeof(CRMCshmHeader) + uint64_t(nSlots) * sizeof(CRMCshmSlot);
+  }
+
+  inline CRMCshmSlot* GetSlot(CRMCshmHeader* header, const uint64_t index)
+  {
+    char* slots = reinterpret_cast<char*>(header) + sizeof(CRMCshmHeader);
+    return reinterpret_cast<CRMCshmSlot*>(slots) + index % header->fNSlots;
+  }
+
+  /** Poll interval of the producer and consumer when they wait on each other */
+  const long kWaitNanoSeconds = 20000;
+  /** Polls between the checks whether the other side is still running */
+  const long kPollsPerCheck = 1000;
+
+  inline double Seconds()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+  }
+
+  /** False once the process has ended (EPERM: it runs under another user) */
+  inline bool IsRunning(const int32_t pid)
+  {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+  }
+}
+
+#endif
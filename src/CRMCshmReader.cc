@@ -0,0 +1,125 @@
+#include <CRMCshmReader.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace CRMCshm;
+
+
+namespace {
+  void
+  Wait()
+  {
+    struct timespec ts = {0, kWaitNanoSeconds};
+    nanosleep(&ts, 0);
+  }
+}
+
+
+CRMCshmReader::CRMCshmReader(const string& name, const double timeout)
+  : fHeader(0),
+    fSize(0),
+    fHoldsSlot(false)
+{
+  const string shmName = name[0] == '/' ? name : "/" + name;
+
+  // crmc may still be starting up (model initialisation)
+  const double deadline = Seconds() + timeout;
+  int fd = -1;
+  while (fd < 0) {
+    fd = shm_open(shmName.c_str(), O_RDWR, 0);
+    if (fd < 0 && (errno != ENOENT || Seconds() > deadline))
+      throw runtime_error("CRMCshmReader: cannot open " + shmName + ": " + strerror(errno));
+    if (fd < 0)
+      Wait();
+  }
+
+  // the producer sizes the segment right after creating it
+  struct stat st;
+  while (true) {
+    if (fstat(fd, &st) != 0) {
+      const string error = strerror(errno);
+      close(fd);
+      throw runtime_error("CRMCshmReader: cannot stat " + shmName + ": " + error);
+    }
+    if (st.st_size >= off_t(sizeof(CRMCshmHeader)))
+      break;
+    if (Seconds() > deadline) {
+      close(fd);
+      throw runtime_error("CRMCshmReader: " + shmName + " was not sized by crmc in time");
+    }
+    Wait();
+  }
+  fSize = st.st_size;
+
+  void* mem = mmap(0, fSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED)
+    throw runtime_error("CRMCshmReader: cannot map " + shmName + ": " + strerror(errno));
+  fHeader = static_cast<CRMCshmHeader*>(mem);
+
+  while (fHeader->fMagic.load(std::memory_order_acquire) != kMagic) {
+    if (Seconds() > deadline) {
+      munmap(fHeader, fSize);
+      throw runtime_error("CRMCshmReader: " + shmName + " was not initialised by crmc in time");
+    }
+    Wait();
+  }
+  if (fHeader->fVersion != kVersion || fHeader->fMaxParticles != kMaxParticles
+      || fHeader->fSlotSize != sizeof(CRMCshmSlot) || fSize < SegmentSize(fHeader->fNSlots)) {
+    munmap(fHeader, fSize);
+    throw runtime_error("CRMCshmReader: " + shmName + " was written by an incompatible crmc"
+                        " (different version or HepMC_HEPEVT_SIZE)");
+  }
+  fHeader->fConsumerPid.store(getpid(), std::memory_order_release);
+}
+
+
+CRMCshmReader::~CRMCshmReader()
+{
+  // crmc waits for a new consumer again
+  int32_t pid = getpid();
+  fHeader->fConsumerPid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+  munmap(fHeader, fSize);
+}
+
+
+const CRMCshmSlot*
+CRMCshmReader::Next()
+{
+  if (fHoldsSlot)
+    Release();
+
+  const uint64_t iRead = fHeader->fReadIndex.load(std::memory_order_relaxed);
+  for (long nPolls = 1; fHeader->fWriteIndex.load(std::memory_order_acquire) == iRead; ++nPolls) {
+    // check the write index again: the last event may come with the close flag
+    if (fHeader->fClosed.load(std::memory_order_acquire)
+        && fHeader->fWriteIndex.load(std::memory_order_acquire) == iRead)
+      return 0;
+    if (nPolls % kPollsPerCheck == 0 && !IsRunning(fHeader->fProducerPid)
+        && !fHeader->fClosed.load(std::memory_order_acquire)
+        && fHeader->fWriteIndex.load(std::memory_order_acquire) == iRead)
+      throw runtime_error("CRMCshmReader: crmc has ended without closing the event stream");
+    Wait();
+  }
+  fHoldsSlot = true;
+  return GetSlot(fHeader, iRead);
+}
+
+
+void
+CRMCshmReader::Release()
+{
+  if (!fHoldsSlot)
+    return;
+  fHoldsSlot = false;
+  fHeader->fReadIndex.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,47 @@
+#ifndef _CRMCshmReader_h_
+#define _CRMCshmReader_h_
+#include "CRMCshm.h"
+
+#include <string>
+
+/**
+ * Consumer side of the shared-memory event ring (crmc -o shm).
+ *
+ * Typical use in a detector simulation on the same node:
+ *
+ *   CRMCshmReader reader("/crmc_1234");
+ *   while (const CRMCshm::CRMCshmSlot* event = reader.Next()) {
+ *     // ... use event->fNParticles, event->fPartId[i], ...
+ *     reader.Release();
+ *   }
+ *
+ * The event stays valid until Release() is called; crmc cannot
+ * overwrite it before. Errors are reported with std::runtime_error,
+ * also when crmc ends without closing the stream (e.g. crashes).
+ * The reader must be built with the HepMC_HEPEVT_SIZE of crmc.
+ */
+class CRMCshmReader {
+
+ public:
+  /** Attach to the segment, waiting up to timeout seconds for crmc to create it */
+  CRMCshmReader(const std::string& name, const double timeout = 60);
+  ~CRMCshmReader();
+
+  /** Next event, or 0 when crmc has finished and all events were read */
+  const CRMCshm::CRMCshmSlot* Next();
+  /** Give the last event returned by Next() back to crmc */
+  void Release();
+
+  const CRMCshm::CRMCshmHeader& GetHeader() const { return *fHeader; }
+
+ private:
+  CRMCshmReader(const CRMCshmReader&);
+  CRMCshmReader& operator=(const CRMCshmReader&);
+
+  CRMCshm::CRMCshmHeader* fHeader;
+  unsigned long long fSize;
+  bool fHoldsSlot;
+};
+
+
+#endif
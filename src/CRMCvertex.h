@@ -0,0 +1,62 @@
+// -*- mode: C++ -*-
+/**
+ * @file      src/CRMCvertex.h
+ *
+ * @brief  Collision vertex distribution of the RHICf run types
+ */
+#ifndef CRMCvertex_h
+#define CRMCvertex_h
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+/**
+ * Gaussian spread of the collision vertex at STAR for the RHICf run
+ * types (TL, TS, TOP), used by the RHICf output and to place the
+ * pileup collisions.  Other run types (ALL) are centred at 0.
+ *
+ * @ingroup utils
+ */
+struct CRMCvertex
+{
+  CRMCvertex() { init(""); }
+
+  void init(std::string runType)
+  {
+    std::transform(runType.begin(), runType.end(), runType.begin(), ::toupper);
+
+    mean[0] = 0.; // x
+    mean[1] = 0.; // y
+    mean[2] = 0.;
+    if (runType.find("TL") != std::string::npos) {
+      mean[0] = 0.044 * 10.; // [mm]
+      mean[1] = 0.186 * 10.; // [mm]
+    }
+    else if (runType.find("TS") != std::string::npos) {
+      mean[0] = 0.022 * 10.; // [mm]
+      mean[1] = 0.19 * 10.; // [mm]
+    }
+    else if (runType.find("TOP") != std::string::npos) {
+      mean[0] = 0.022 * 10.; // [mm]
+      mean[1] = -0.053 * 10.; // [mm]
+    }
+    sigma[0] = 0.2; // [mm]
+    sigma[1] = 0.2; // [mm]
+    sigma[2] = 300.; // [mm]
+  }
+
+  /** Draw a vertex, gaus(mean, sigma) is any Gaussian random generator */
+  template <typename Gaus>
+  void draw(Gaus gaus, double vertex[3]) const
+  {
+    for (int i = 0; i < 3; i++)
+      vertex[i] = gaus(mean[i], sigma[i]);
+  }
+
+  double mean[3];  // mm [x, y, z]
+  double sigma[3]; // mm [x, y, z]
+};
+#endif
+//
+// EOF
+//
@@ -0,0 +1,73 @@
+#include <OutputPolicyComposite.h>
+
+#include <CRMCoptions.h>
+#include <CRMCinterface.h>
+
+using namespace std;
+
+
+OutputPolicyComposite::OutputPolicyComposite()
+{
+}
+
+
+OutputPolicyComposite::~OutputPolicyComposite()
+{
+}
+
+
+void
+OutputPolicyComposite::AddSink(OutputPolicyNone* output, const CRMCoptions& cfg)
+{
+  fSinks.emplace_back(output);
+  fSinkCfgs.emplace_back(new CRMCoptions(cfg));
+}
+
+
+void
+OutputPolicyComposite::InitOutput(const CRMCoptions&)
+{
+  for (size_t i = 0; i < fSinks.size(); ++i)
+    fSinks[i]->InitOutput(*fSinkCfgs[i]);
+}
+
+
+void
+OutputPolicyComposite::FillEvent(const CRMCoptions&, const int nEvent)
+{
+  for (size_t i = 0; i < fSinks.size(); ++i) {
+    gCRMC_data.Store(fSinkCfgs[i]->GetTypout());
+    fSinks[i]->FillEvent(*fSinkCfgs[i], nEvent);
+  }
+}
+
+
+void
+OutputPolicyComposite::FillRHICfEvent(const CRMCoptions&, const int nEvent, int& passEventNum)
+{
+  int mainPassEventNum = passEventNum;
+  for (size_t i = 0; i < fSinks.size(); ++i) {
+    int sinkPassEventNum = passEventNum;
+    gCRMC_data.Store(fSinkCfgs[i]->GetTypout());
+    fSinks[i]->FillRHICfEvent(*fSinkCfgs[i], nEvent, sinkPassEventNum);
+    if (i == 0)
+      mainPassEventNum = sinkPassEventNum;
+  }
+  passEventNum = mainPassEventNum;
+}
+
+
+void
+OutputPolicyComposite::CloseOutput(const CRMCoptions&)
+{
+  for (size_t i = 0; i < fSinks.size(); ++i)
+    fSinks[i]->CloseOutput(*fSinkCfgs[i]);
+}
+
+
+void
+OutputPolicyComposite::PrintTestEvent(const CRMCoptions&)
+{
+  for (size_t i = 0; i < fSinks.size(); ++i)
+    fSinks[i]->PrintTestEvent(*fSinkCfgs[i]);
+}
@@ -0,0 +1,43 @@
+#ifndef _OutputPolicyComposite_h_
+#define _OutputPolicyComposite_h_
+#include "OutputPolicyNone.h"
+
+#include <memory>
+#include <vector>
+
+class CRMCoptions;
+
+/**
+ * Forwards every generated event to several output policies.
+ *
+ * Each sink keeps its own copy of the options (output mode and file
+ * name, see CRMCoptions::ForOutputSink), so the policies do not need
+ * to know they are being fanned out.  A sink of another output type
+ * (ROOT next to HepMC) gets the event stored again for it, see
+ * CRMCdata::Store.  The first sink added is the main one (-o): it
+ * alone decides if a collision counts as a passed event, all others
+ * see every collision.
+ */
+class OutputPolicyComposite : public OutputPolicyNone {
+
+ public:
+  OutputPolicyComposite();
+  ~OutputPolicyComposite() override;
+
+  /** Add a sink, ownership of output is taken over */
+  void AddSink(OutputPolicyNone* output, const CRMCoptions& cfg);
+
+  void InitOutput(const CRMCoptions& cfg) override;
+  void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
+  void FillRHICfEvent(const CRMCoptions& cfg, const int nEvent, int& passEventNum) override;
+  void CloseOutput(const CRMCoptions& cfg) override;
+
+  void PrintTestEvent(const CRMCoptions& cfg) override;
+
+ private:
+  std::vector<std::unique_ptr<OutputPolicyNone> > fSinks;
+  std::vector<std::unique_ptr<CRMCoptions> > fSinkCfgs;
+};
+
+
+#endif
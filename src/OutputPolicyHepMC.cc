@@ -39,22 +39,59 @@ using namespace std;
 
 
 OutputPolicyHepMC::OutputPolicyHepMC()
+  : fOut(0),
+    fBlockOut(0),
+    ascii_out(0)
 {
+#ifdef HEPMC_HAS_UNITS
+  fEvtHepMC = new HepMC::GenEvent(HepMC::Units::GEV, HepMC::Units::MM);
+#else
+  fEvtHepMC = new HepMC::GenEvent();
+#endif
+}
+
+
+OutputPolicyHepMC::~OutputPolicyHepMC()
+{
+  // the vertices belong to the pool, take them out before deleting the event
+  fEvtHepMC->set_beam_particles(0,0);
+  fEvtHepMC->set_signal_process_vertex(0);
+  hepevt.factory().reset();
+  delete fEvtHepMC;
 }
 
 
 void
 OutputPolicyHepMC::InitOutput(const CRMCoptions& cfg)
 {
-  boost::filesystem::path oldFile(cfg.GetOutputFileName());
-  if(!boost::filesystem::is_other(cfg.GetOutputFileName())) //protect fifo file
+  fShardIdx = 0;
+  OpenFile(cfg);
+}
+
+
+void
+OutputPolicyHepMC::OpenFile(const CRMCoptions& cfg)
+{
+  fFileName = cfg.GetOutputFileName();
+  if (cfg.IsSharded())
+    fFileName = cfg.GetShardFileName(fFileName, cfg.GetOutputTypeEnding(), fShardIdx);
+  fShardEvents = 0;
+
+  boost::filesystem::path oldFile(fFileName);
+  if(!boost::filesystem::is_other(fFileName)) //protect fifo file
     boost::filesystem::remove(oldFile); //before liboost v1.44 truncate does not seem to work properly in boost
 
+  if (cfg.GetOutputMode()==CRMCoptions::eHepMCGZ && cfg.GetBlockEvents() > 0) {
+    fBlockOut = new CRMCblockGzip(fFileName);
+    ascii_out = new HepMC::IO_GenEvent(*fBlockOut);
+    return;
+  }
+
   //io::filtering_ostream out; //top to bottom order
   fOut = new io::filtering_ostream();
   if (cfg.GetOutputMode()==CRMCoptions::eHepMCGZ)
     fOut->push(io::gzip_compressor(io::zlib::best_compression));
-  fOut->push(io::file_descriptor_sink(cfg.GetOutputFileName()), ios_base::trunc);
+  fOut->push(io::file_descriptor_sink(fFileName), ios_base::trunc);
 
   // Instantiate an IO strategy to write the data to file
   ascii_out = new HepMC::IO_GenEvent(*fOut);
@@ -62,15 +99,23 @@ OutputPolicyHepMC::InitOutput(const CRMCoptions& cfg)
 
 
 void
-OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
+OutputPolicyHepMC::CloseFile()
 {
-#ifdef HEPMC_HAS_UNITS
-  HepMC::GenEvent* fEvtHepMC = new HepMC::GenEvent(HepMC::Units::GEV,
-						   HepMC::Units::MM);
-#else
-  HepMC::GenEvent* fEvtHepMC = new HepMC::GenEvent();
-#endif
+  delete ascii_out; // writes the end-of-listing line
+  delete fOut;
+  delete fBlockOut;
+  ascii_out = 0;
+  fOut = 0;
+  fBlockOut = 0;
+}
 
+
+void
+OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
+{
+ // the particles of the last event are recycled by convert()
+ fEvtHepMC->set_beam_particles(0,0);
+ fEvtHepMC->set_signal_process_vertex(0);
  if (!hepevt.convert()) {
    // delete fEvtHepMC;
    throw std::runtime_error("!!!Could not read next event");
@@ -82,19 +127,24 @@ OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
  fEvtHepMC->set_beam_particles(b1,b2);
 
  if (!cfg.IsTest()){
+   // the event header objects are created with the first event and
+   // updated in place afterwards
+   if (!fEvtHepMC->heavy_ion()) {
 #ifdef HEPMC_HAS_CROSS_SECTION
-   // set cross section information for this event
-   HepMC::GenCrossSection crossSection;
-   crossSection.set_cross_section(1e9*(cfg.GetProjectileId()>1 || cfg.GetTargetId()>1 ?
-					  gCRMC_data.sigineaa : 
-					  gCRMC_data.sigine)); //required in pB
-   fEvtHepMC->set_cross_section(crossSection);
+     fEvtHepMC->set_cross_section(HepMC::GenCrossSection());
 #endif
+     // provide optional pdf set id numbers for CMSSW to work flavour of
+     // partons and stuff. hope it's optional
+     fEvtHepMC->set_pdf_info(HepMC::PdfInfo(0, 0, 0, 0, 0, 0, 0));
+     fEvtHepMC->set_heavy_ion(HepMC::HeavyIon());
+   }
 
-   // provide optional pdf set id numbers for CMSSW to work flavour of
-   // partons and stuff. hope it's optional
-   HepMC::PdfInfo pdf(0, 0, 0, 0, 0, 0, 0);
-   fEvtHepMC->set_pdf_info(pdf);
+#ifdef HEPMC_HAS_CROSS_SECTION
+   // set cross section information for this event
+   fEvtHepMC->cross_section()->set_cross_section(1e9*(cfg.GetProjectileId()>1 || cfg.GetTargetId()>1 ?
+							gCRMC_data.sigineaa :
+							gCRMC_data.sigine)); //required in pB
+#endif
    
    //Setting heavy ion infromation
    // 
@@ -120,20 +170,20 @@ OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
    //  sigma_inel_NN                 nucleon-nucleon inelastic
    //                                (including diffractive) cross-section
    
-   HepMC::HeavyIon ion(gCRMC_data.kohevt,
-		       gCRMC_data.npjevt,
-		       gCRMC_data.ntgevt,
-		       gCRMC_data.kolevt,
-		       gCRMC_data.npnevt + gCRMC_data.ntnevt,
-		       gCRMC_data.nppevt + gCRMC_data.ntpevt,
-		       gCRMC_data.ng1evt,
-		       gCRMC_data.ng2evt,
-		       gCRMC_data.nglevt,
-		       gCRMC_data.bimevt,
-		       gCRMC_data.phievt,
-		       gCRMC_data.fglevt,  //defined only if phimin=phimax=0.
-		       gCRMC_data.sigine*1e9); //required in pB
-   fEvtHepMC->set_heavy_ion(ion);
+   HepMC::HeavyIon* ion = fEvtHepMC->heavy_ion();
+   ion->set_Ncoll_hard(gCRMC_data.kohevt);
+   ion->set_Npart_proj(gCRMC_data.npjevt);
+   ion->set_Npart_targ(gCRMC_data.ntgevt);
+   ion->set_Ncoll(gCRMC_data.kolevt);
+   ion->set_spectator_neutrons(gCRMC_data.npnevt + gCRMC_data.ntnevt);
+   ion->set_spectator_protons(gCRMC_data.nppevt + gCRMC_data.ntpevt);
+   ion->set_N_Nwounded_collisions(gCRMC_data.ng1evt);
+   ion->set_Nwounded_N_collisions(gCRMC_data.ng2evt);
+   ion->set_Nwounded_Nwounded_collisions(gCRMC_data.nglevt);
+   ion->set_impact_parameter(gCRMC_data.bimevt);
+   ion->set_event_plane_angle(gCRMC_data.phievt);
+   ion->set_eccentricity(gCRMC_data.fglevt);  //defined only if phimin=phimax=0.
+   ion->set_sigma_inel_NN(gCRMC_data.sigine*1e9); //required in pB
 
    // add some information to the event
    fEvtHepMC->set_event_number(nEvent);
@@ -169,7 +219,24 @@ OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
 
 
    // write the event out to the ascii file
+   if (!ascii_out)
+     OpenFile(cfg); // previous shard was full
+   if (fBlockOut && fShardEvents % cfg.GetBlockEvents() == 0)
+     fBlockOut->StartBlock(nEvent);
    (*ascii_out) << fEvtHepMC;
+
+   // close the shard when it is full, the next one is opened with the
+   // next event so that no empty shard is left at the end; the compressed
+   // size is only known once the buffers are flushed so --shard-bytes is
+   // approximate
+   ++fShardEvents;
+   if ((cfg.GetShardEvents() > 0 && fShardEvents >= cfg.GetShardEvents())
+       || (cfg.GetShardBytes() > 0
+           && boost::filesystem::is_regular_file(fFileName)
+           && (long long)boost::filesystem::file_size(fFileName) >= cfg.GetShardBytes())) {
+     CloseFile();
+     ++fShardIdx;
+   }
  }
  else {
   // Test mode : compute directly some observables
@@ -199,8 +266,7 @@ OutputPolicyHepMC::FillEvent(const CRMCoptions& cfg, const int nEvent)
   _m  .fill(multiplicity);
   _mid.fill(plateau);
  }
- // we also need to delete the created event from memory
- delete fEvtHepMC;
+ // the event is kept, its particles and vertices are reused for the next one
 }
 
 
@@ -208,8 +274,7 @@ void
 OutputPolicyHepMC::CloseOutput(const CRMCoptions& cfg)
 {
   //fOut->close();
-  delete ascii_out;
-  delete fOut;
+  CloseFile(); // nothing open if the last shard was just full
 }
 
 //--------------------------------------------------------------------
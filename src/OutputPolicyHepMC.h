@@ -6,8 +6,12 @@
 #include <HepMC/GenVertex.h>
 #include "OutputPolicyNone.h"
 #include "CRMChepevt.h"
+#include "CRMChepmc2pool.h"
+#include "CRMCblockgzip.h"
 #include "CRMCstat.h"
 
+#include <string>
+
 class CRMCoptions;
 
 namespace HepMC {
@@ -21,6 +25,7 @@ class OutputPolicyHepMC : public OutputPolicyNone {
 
  public:
   OutputPolicyHepMC();
+  ~OutputPolicyHepMC() override;
 
   void InitOutput(const CRMCoptions& cfg) override;
   void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
@@ -28,12 +33,21 @@ class OutputPolicyHepMC : public OutputPolicyNone {
 
   void PrintTestEvent(const CRMCoptions& cfg) override;
  private:
+  void OpenFile(const CRMCoptions& cfg);
+  void CloseFile();
+
   boost::iostreams::filtering_ostream *fOut;
+  CRMCblockGzip* fBlockOut; // instead of fOut with --block-events
   CRMChepevt<HepMC::GenParticle*,
 	     HepMC::GenVertex*,
 	     HepMC::FourVector,
-	     HepMC::GenEvent> hepevt;
+	     HepMC::GenEvent,
+	     CRMChepmc2pool> hepevt;
+  HepMC::GenEvent* fEvtHepMC; // reused for all events, filled from the pool of hepevt
   HepMC::IO_GenEvent* ascii_out;
+  std::string fFileName;
+  int fShardIdx;
+  int fShardEvents;
 
  protected:
   Stat<double> _eta;
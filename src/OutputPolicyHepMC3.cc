@@ -71,28 +71,22 @@ void OutputPolicyHepMC3::InitOutput(const CRMCoptions& cfg)
     TString jobIndex = cfg.GetJobIndex();
     if(jobIndex != ""){jobIndex = "_" + jobIndex;}
 
-    TString outputName = outputPath +"/crmc_"+ modelName +"_"+ rhicfRunTypeName +"_"+ jobTime + jobIndex +".RHICfSimGenerator.root";
-    
-    fFile = new TFile(outputName, "recreate");
-    fRunTree = new TTree("Run", "Run");
-    fEventTree = new TTree("Event", "Event");
-
-    fRunTree -> Branch("RHICfRunType", &fRHICfRunType, "RHICfRunType/I");
-    fRunTree -> Branch("ModelType", &fModelIdx, "ModelType/I");
-    fRunTree -> Fill();
+    fOutputName = outputPath +"/crmc_"+ modelName +"_"+ rhicfRunTypeName +"_"+ jobTime + jobIndex +".RHICfSimGenerator.root";
+    if(cfg.IsOutputFileNameSet()){fOutputName = cfg.GetOutputFileName();} // e.g. given with --sink hepmc3:file
 
+    fSeed = cfg.GetSeed();
+    fShardIdx = -1;
     fParticleArray = new TClonesArray("TParticle");
-    fEventTree -> Branch("ProcessID", &fProcessID, "ProcessID/I");
-    fEventTree -> Branch("Particles", &fParticleArray);
+    OpenShard(cfg);
 
     fRandom = new TRandom3(cfg.GetSeed());
-    InitVertexFluctuation();
+    fVertexFluctuation.init(cfg.GetRHICfRunType());
     if(fRHICfRunType != kALL){InitRHICfGeometry();}
 
     cout << "--- RHICfSimGenerator Initialization ---" << endl;
     cout << "Model          : " << modelName << endl;
     cout << "RHICf Run Type : " << rhicfRunTypeName << endl;
-    cout << "Output File    : " << outputName << endl;
+    cout << "Output File    : " << fFile -> GetName() << endl;
     cout << "Initialization --- done..." << endl;
 }
 
@@ -101,14 +95,38 @@ void OutputPolicyHepMC3::FillRHICfEvent(const CRMCoptions& cfg, const int nEvent
 {
     if (!_hepevt.convert(_event)){throw std::runtime_error("!!!Could not read next event");}
     if (!cfg.IsTest()){_hepmc3.fillInEvent(cfg, nEvent, _event);}
+    if(!fFile){OpenShard(cfg);} // previous shard was full
     fParticleArray -> Clear("C");
+    fNCollision++;
+    fCollision = nEvent;
+    fEventSeed = gCRMC_data.fEventSeed;
+
+    // the vertex has to follow the event seed to regenerate the event
+    if(fEventSeed > 0){fRandom -> SetSeed(fEventSeed);}
 
     // random vertex for STAR
-    double collisionVtxX = fRandom -> Gaus(fVertexMean[0], fVertexSigma[0]); // [mm]
-    double collisionVtxY = fRandom -> Gaus(fVertexMean[1], fVertexSigma[1]); // [mm]
-    double collisionVtxZ = fRandom -> Gaus(fVertexMean[2], fVertexSigma[2]); // [mm]
+    double collisionVtx[3]; // [mm]
+    fVertexFluctuation.draw([this](double mean, double sigma){return fRandom -> Gaus(mean, sigma);}, collisionVtx);
+    double vertexShift[3] = {collisionVtx[0], collisionVtx[1], collisionVtx[2]};
+    if(gCRMC_data.fNPileup >= 0){
+        // pileup: all collisions were already placed, see CRMCpileup
+        for(int i=0; i<3; i++){
+            collisionVtx[i] = gCRMC_data.fVertex[i];
+            vertexShift[i] = 0.;
+        }
+    }
 
     fProcessID = gCRMC_data.typevt;
+    fImpactParameter = gCRMC_data.bimevt;
+    fNPartProj = gCRMC_data.npjevt;
+    fNPartTarg = gCRMC_data.ntgevt;
+    fVertex[0] = collisionVtx[0];
+    fVertex[1] = collisionVtx[1];
+    fVertex[2] = collisionVtx[2];
+    fNFinal = 0;
+    // ALL has no detector position, so no hits: -1 tells it from "no hit"
+    fLeadingNeutralE[0] = (fRHICfRunType == kALL ? -1. : 0.);
+    fLeadingNeutralE[1] = (fRHICfRunType == kALL ? -1. : 0.);
 
     int RHICfHitTrkNum = 0;
     int particleNum = _event.particles_size();
@@ -119,9 +137,9 @@ void OutputPolicyHepMC3::FillRHICfEvent(const CRMCoptions& cfg, const int nEvent
         int id = p -> id();
         int pid = p -> pdg_id();
         double eta = p -> momentum().pseudoRapidity();
-        double vx = p -> production_vertex()->position().x() + collisionVtxX; // [mm]
-        double vy = p -> production_vertex()->position().y() + collisionVtxY; // [mm]
-        double vz = p -> production_vertex()->position().z() + collisionVtxZ; // [mm]
+        double vx = p -> production_vertex()->position().x() + vertexShift[0]; // [mm]
+        double vy = p -> production_vertex()->position().y() + vertexShift[1]; // [mm]
+        double vz = p -> production_vertex()->position().z() + vertexShift[2]; // [mm]
         double t = p -> production_vertex()->position().t(); // [mm/c]
         double px = p -> momentum().px();
         double py = p -> momentum().py();
@@ -163,6 +181,7 @@ void OutputPolicyHepMC3::FillRHICfEvent(const CRMCoptions& cfg, const int nEvent
         fParticle -> SetFirstDaughter(daughterIdx1);
         fParticle -> SetLastDaughter(daughterIdx2);
 
+        if(stat == 1){fNFinal++;}
         if(fRHICfRunType == kALL){continue;}
         if(stat != 1){continue;} // only final state
 
@@ -179,62 +198,102 @@ void OutputPolicyHepMC3::FillRHICfEvent(const CRMCoptions& cfg, const int nEvent
         int hit = GetRHICfGeoHit(vx, vy, vz, px, py, pz, e);
         if(hit < 0){continue;}
 
+        if(isInterest && e > fLeadingNeutralE[hit-1]){fLeadingNeutralE[hit-1] = e;}
         RHICfHitTrkNum++;
     }
-
-    if(fRHICfRunType != kALL){
-        if(RHICfHitTrkNum != 0){
-            fEventTree -> Fill();
-            PrintEvent();
-            passEventNum++;
-        }
-    }
-    else{
-        fEventTree -> Fill();
-        passEventNum++;
-    }
+    fMultiplicity = particleNum;
+
+    bool isAccepted = (fRHICfRunType == kALL || RHICfHitTrkNum != 0);
+    if(!isAccepted){return;}
+
+    if(fEventTree){fEventTree -> Fill();}
+    fSummaryTree -> Fill();
+    if(fRHICfRunType != kALL){PrintEvent();}
+    fNAccepted++;
+    passEventNum++;
+
+    // rotate to the next shard, it is only opened when the next event comes
+    bool isShardFull = false;
+    if(cfg.GetShardEvents() > 0 && fNAccepted >= cfg.GetShardEvents()){isShardFull = true;}
+    if(cfg.GetShardBytes() > 0 && fFile -> GetEND() >= cfg.GetShardBytes()){isShardFull = true;}
+    if(isShardFull){CloseShard();}
 }
 
 //--------------------------------------------------------------------
 void OutputPolicyHepMC3::CloseOutput(const CRMCoptions&)
+{
+    if(fFile){CloseShard();}
+    cout << "OutputPolicyHepMC3::CloseOutput() --- Written the File !" << endl;
+}
+
+void OutputPolicyHepMC3::OpenShard(const CRMCoptions& cfg)
+{
+    fShardIdx++;
+    fNCollision = 0;
+    fNAccepted = 0;
+
+    TString fileName = fOutputName;
+    if(cfg.IsSharded()){fileName = cfg.GetShardFileName(fOutputName.Data(), ".RHICfSimGenerator.root", fShardIdx);}
+
+    fFile = new TFile(fileName, "recreate");
+    fRunTree = new TTree("Run", "Run");
+    fEventTree = 0;
+    if(!cfg.IsSeedsOnly()){fEventTree = new TTree("Event", "Event");} // --seeds-only: regenerate instead
+    fSummaryTree = new TTree("Summary", "Per-event summary, one entry per Event entry");
+
+    fRunTree -> Branch("RHICfRunType", &fRHICfRunType, "RHICfRunType/I");
+    fRunTree -> Branch("ModelType", &fModelIdx, "ModelType/I");
+    fRunTree -> Branch("Seed", &fSeed, "Seed/I");
+    fRunTree -> Branch("ShardIndex", &fShardIdx, "ShardIndex/I");
+    fRunTree -> Branch("NCollision", &fNCollision, "NCollision/I");
+    fRunTree -> Branch("NAccepted", &fNAccepted, "NAccepted/I");
+
+    if(fEventTree){
+        fEventTree -> Branch("ProcessID", &fProcessID, "ProcessID/I");
+        fEventTree -> Branch("Particles", &fParticleArray);
+    }
+
+    // small enough to be read for a selection before touching the particles,
+    // e.g. Event->Draw("Particles.fPdgCode", "Summary.LeadingNeutralE[1] > 50")
+    fSummaryTree -> Branch("ProcessID", &fProcessID, "ProcessID/I");
+    fSummaryTree -> Branch("ImpactParameter", &fImpactParameter, "ImpactParameter/F");
+    fSummaryTree -> Branch("NPartProj", &fNPartProj, "NPartProj/I");
+    fSummaryTree -> Branch("NPartTarg", &fNPartTarg, "NPartTarg/I");
+    fSummaryTree -> Branch("Multiplicity", &fMultiplicity, "Multiplicity/I");
+    fSummaryTree -> Branch("NFinal", &fNFinal, "NFinal/I");
+    fSummaryTree -> Branch("LeadingNeutralE", fLeadingNeutralE, "LeadingNeutralE[2]/F");
+    fSummaryTree -> Branch("Vertex", fVertex, "Vertex[3]/F");
+    fSummaryTree -> Branch("Collision", &fCollision, "Collision/I");
+    fSummaryTree -> Branch("EventSeed", &fEventSeed, "EventSeed/I");
+    if(fEventTree){fEventTree -> AddFriend(fSummaryTree);}
+}
+
+void OutputPolicyHepMC3::CloseShard()
 {
     fFile -> cd();
+    fRunTree -> Fill(); // Run metadata of this shard
     fRunTree -> Write();
-    fEventTree -> Write();
+    if(fEventTree){fEventTree -> Write();}
+    fSummaryTree -> Write();
     fFile -> Close();
-    cout << "OutputPolicyHepMC3::CloseOutput() --- Written the File !" << endl;
+    cout << "OutputPolicyHepMC3::CloseShard() --- " << fFile -> GetName() << " : " << fNAccepted << " events" << endl;
+
+    delete fFile; // also deletes the trees
+    fFile = 0;
+    fRunTree = 0;
+    fEventTree = 0;
+    fSummaryTree = 0;
 }
 
 void OutputPolicyHepMC3::PrintEvent()
 {
     cout << "--- CRMC RHICfSimGenerator::PrintEvent() --- " << endl;
-    cout << " Event Number          : " << fEventTree -> GetEntries() << endl;
+    cout << " Event Number          : " << fSummaryTree -> GetEntries() << endl;
+    if(fShardIdx > 0){cout << " Shard Index           : " << fShardIdx << endl;}
     cout << " Event Process Id      : " << fProcessID  << endl;
     cout << " Total Particle Number : " << fParticleArray -> GetEntries() << endl;
 }
 
-void OutputPolicyHepMC3::InitVertexFluctuation()
-{
-    fVertexMean[0] = 0.; // x
-    fVertexMean[1] = 0.; // y
-    fVertexMean[2] = 0.;
-    if(fRHICfRunType == kTL){
-        fVertexMean[0] = 0.044 * 10.; // [mm]
-        fVertexMean[1] = 0.186 * 10.; // [mm]
-    }
-    else if(fRHICfRunType == kTS){
-        fVertexMean[0] = 0.022 * 10.; // [mm]
-        fVertexMean[1] = 0.19 * 10.; // [mm]
-    }
-    else if(fRHICfRunType == kTOP){
-        fVertexMean[0] = 0.022 * 10.; // [mm]
-        fVertexMean[1] = -0.053 * 10.; // [mm]
-    }
-    fVertexSigma[0] = 0.2; // [mm]
-    fVertexSigma[1] = 0.2; // [mm]
-    fVertexSigma[2] = 300.; // [mm]
-}
-
 void OutputPolicyHepMC3::InitRHICfGeometry()
 {
     double tsDetSize = 20.; // [mm]
@@ -8,8 +8,10 @@
 #include <HepMC3/GenVertex.h>
 #include "OutputPolicyNone.h"
 #include "CRMChepevt.h"
+#include "CRMCarena.h"
 #include "CRMChepmc3.h"
 #include "CRMCstat.h"
+#include "CRMCvertex.h"
 
 #include "TRandom3.h"
 #include "TString.h"
@@ -39,16 +41,20 @@ class OutputPolicyHepMC3 : public OutputPolicyNone
         void CloseOutput(const CRMCoptions& cfg) override;
 
     private:
+        void OpenShard(const CRMCoptions& cfg);
+        void CloseShard();
         void PrintEvent();
-        void InitVertexFluctuation();
         void InitRHICfGeometry();
-        bool IsNeutralParticle(int pid);
+        bool IsInterestedParticle(int pid);
         int GetRHICfGeoHit(double posX, double posY, double posZ, double px, double py, double pz, double e);
 
         CRMChepevt<HepMC3::GenParticlePtr,
             HepMC3::GenVertexPtr,
             HepMC3::FourVector,
-            HepMC3::GenEvent> _hepevt;
+            HepMC3::GenEvent,
+            CRMCarenaFactory<HepMC3::GenParticlePtr,
+                             HepMC3::GenVertexPtr,
+                             HepMC3::FourVector>> _hepevt;
         CRMChepmc3 _hepmc3;
         HepMC3::GenEvent _event;
 
@@ -61,10 +67,28 @@ class OutputPolicyHepMC3 : public OutputPolicyNone
         Int_t fModelIdx;
         Int_t fProcessID;
 
+        // ====== per-event summary for pre-selection, friend of the Event tree =======
+        TTree* fSummaryTree;
+        Int_t fCollision; // collision number, with the seed enough to regenerate the event
+        Int_t fEventSeed; // 0 without --event-seeds
+        Float_t fImpactParameter;
+        Int_t fNPartProj;
+        Int_t fNPartTarg;
+        Int_t fMultiplicity; // all particles of the event
+        Int_t fNFinal; // final state particles
+        Float_t fLeadingNeutralE[2]; // [TS, TL] highest energy n, K0_L or gamma hitting the tower
+        Float_t fVertex[3]; // collision vertex [x, y, z] in mm
+
+        // ====== output sharding (--shard-events, --shard-bytes) =======
+        TString fOutputName;
+        Int_t fSeed;
+        Int_t fShardIdx;
+        Int_t fNCollision; // collisions generated while the shard was open
+        Int_t fNAccepted; // events written to the shard
+
         // ====== vertex fluctuation parameters =======
         TRandom3* fRandom;
-        double fVertexMean[3]; // mm [x, y, z]
-        double fVertexSigma[3]; // mm [x, y, z]
+        CRMCvertex fVertexFluctuation;
 
         // ======== RHICf Geometry =======
         TH2Poly* fRHICfPoly; // only west
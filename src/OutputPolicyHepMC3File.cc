@@ -0,0 +1,155 @@
+#include <OutputPolicyHepMC3File.h>
+
+#include <CRMCoptions.h>
+#include <CRMCinterface.h>
+#include <CRMCconfig.h>
+
+#include <HepMC3/GenRunInfo.h>
+#include <HepMC3/WriterAscii.h>
+#ifdef WITH_HEPMC3_ROOTIO
+#include <HepMC3/WriterRootTree.h>
+#endif
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace io = boost::iostreams;
+
+using namespace std;
+
+namespace {
+  /** Events converted ahead of the writer */
+  const int kQueueDepth = 16;
+}
+
+//--------------------------------------------------------------------
+OutputPolicyHepMC3File::OutputPolicyHepMC3File()
+  : _blockEvents(0),
+    _nWritten(0)
+{}
+
+//--------------------------------------------------------------------
+OutputPolicyHepMC3File::~OutputPolicyHepMC3File()
+{
+  StopWriter();
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyHepMC3File::InitOutput(const CRMCoptions& cfg)
+{
+  // queued events must not share their header with the next one
+  _hepmc3.init(cfg, true);
+
+  ostringstream version;
+  version << CRMC_VERSION_MAJOR << "." << CRMC_VERSION_MINOR << "." << CRMC_VERSION_PATCH;
+  _runInfo = std::make_shared<HepMC3::GenRunInfo>();
+  _runInfo->tools().push_back(HepMC3::GenRunInfo::ToolInfo{"CRMC", version.str(), ""});
+
+  const string fileName = cfg.GetOutputFileName();
+  if (cfg.GetOutputMode() == CRMCoptions::eHepMC3Root) {
+#ifdef WITH_HEPMC3_ROOTIO
+    _writer.reset(new HepMC3::WriterRootTree(fileName, _runInfo));
+#endif
+  }
+  else if (cfg.GetOutputMode() == CRMCoptions::eHepMC3FileGZ && cfg.GetBlockEvents() > 0) {
+    _blockEvents = cfg.GetBlockEvents();
+    _blockOut.reset(new CRMCblockGzip(fileName));
+    _writer.reset(new HepMC3::WriterAscii(*_blockOut, _runInfo));
+  }
+  else {
+    boost::filesystem::path oldFile(fileName);
+    if(!boost::filesystem::is_other(fileName)) //protect fifo file
+      boost::filesystem::remove(oldFile);
+
+    _out.reset(new io::filtering_ostream());
+    if (cfg.GetOutputMode() == CRMCoptions::eHepMC3FileGZ)
+      _out->push(io::gzip_compressor(io::zlib::best_compression));
+    _out->push(io::file_descriptor_sink(fileName), ios_base::trunc);
+    _writer.reset(new HepMC3::WriterAscii(*_out, _runInfo));
+  }
+  if (!_writer || _writer->failed()) {
+    cerr << " Cannot open HepMC3 output file " << fileName << endl;
+    exit(1);
+  }
+
+  _todo.reset(new CRMCqueue<EventPtr>(kQueueDepth));
+  _done.reset(new CRMCqueue<EventPtr>(kQueueDepth + 2));
+  for (int i = 0; i < kQueueDepth + 2; i++)
+    _done->push(EventPtr(new HepMC3::GenEvent(HepMC3::Units::GEV, HepMC3::Units::MM)));
+
+  _writerThread = std::thread(&OutputPolicyHepMC3File::Write, this);
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyHepMC3File::FillEvent(const CRMCoptions& cfg, const int nEvent)
+{
+  {
+    std::lock_guard<std::mutex> lock(_errorMutex);
+    if (_writerError) std::rethrow_exception(_writerError);
+  }
+
+  // take a free event, waits if the writer is behind
+  EventPtr event;
+  _done->pop(event);
+  if (!_hepevt.convert(*event))
+    throw std::runtime_error("!!!Could not read next event");
+
+  event->set_run_info(_runInfo);
+  _hepmc3.fillInEvent(cfg, nEvent, *event);
+  _todo->push(std::move(event));
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyHepMC3File::Write()
+{
+  EventPtr event;
+  while (_todo->pop(event)) {
+    try {
+      if (_blockOut && _nWritten % _blockEvents == 0)
+	_blockOut->StartBlock(event->event_number());
+      _writer->write_event(*event);
+      _nWritten++;
+      if (_writer->failed())
+	throw std::runtime_error("!!!Could not write HepMC3 event");
+    }
+    catch (...) {
+      // reported by the generator thread, keep the events flowing
+      std::lock_guard<std::mutex> lock(_errorMutex);
+      if (!_writerError) _writerError = std::current_exception();
+    }
+    _done->push(std::move(event));
+  }
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyHepMC3File::StopWriter()
+{
+  if (_todo) _todo->close();
+  if (_writerThread.joinable()) _writerThread.join();
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyHepMC3File::CloseOutput(const CRMCoptions& cfg)
+{
+  // all queued events are written before the writer thread stops
+  StopWriter();
+  _writer->close();
+  _writer.reset();
+  _out.reset(); // flushes and finishes the gzip stream
+  _blockOut.reset();
+
+  if (_writerError) std::rethrow_exception(_writerError);
+}
+
+
+//--------------------------------------------------------------------
+//
+// EOF
+//
@@ -0,0 +1,70 @@
+#ifndef _OutputPolicyHepMC3File_h_
+#define _OutputPolicyHepMC3File_h_
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/Writer.h>
+#include <OutputPolicyNone.h>
+#include "CRMChepevt.h"
+#include "CRMCarena.h"
+#include "CRMChepmc3.h"
+#include "CRMCqueue.h"
+#include "CRMCblockgzip.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <boost/iostreams/filtering_stream.hpp>
+class CRMCoptions;
+
+/**
+ * Writes the events to a HepMC3 file (-o hepmc3file, hepmc3filegz or
+ * hepmc3root), the RHICf trees are written by OutputPolicyHepMC3.
+ *
+ * The events are converted on the generator thread and handed through
+ * a bounded queue to a writer thread, so that formatting, compression
+ * and disk access overlap with the generation of the next events.
+ */
+class OutputPolicyHepMC3File : public OutputPolicyNone
+{
+public:
+  OutputPolicyHepMC3File();
+  ~OutputPolicyHepMC3File() override;
+  void InitOutput(const CRMCoptions& cfg) override;
+  void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
+  void CloseOutput(const CRMCoptions& cfg) override;
+private:
+  using EventPtr=std::unique_ptr<HepMC3::GenEvent>;
+
+  void Write();
+  void StopWriter();
+
+  CRMChepevt<HepMC3::GenParticlePtr,
+	     HepMC3::GenVertexPtr,
+	     HepMC3::FourVector,
+	     HepMC3::GenEvent,
+	     CRMCarenaFactory<HepMC3::GenParticlePtr,
+	                      HepMC3::GenVertexPtr,
+	                      HepMC3::FourVector>> _hepevt;
+  CRMChepmc3 _hepmc3;
+  std::shared_ptr<HepMC3::GenRunInfo> _runInfo;
+
+  std::unique_ptr<boost::iostreams::filtering_ostream> _out;
+  std::unique_ptr<CRMCblockGzip> _blockOut; // instead of _out with --block-events
+  int _blockEvents;
+  int _nWritten;
+  std::unique_ptr<HepMC3::Writer> _writer;
+  std::thread _writerThread;
+  /** Converted events waiting to be written */
+  std::unique_ptr<CRMCqueue<EventPtr>> _todo;
+  /** Written events, ready to be filled again */
+  std::unique_ptr<CRMCqueue<EventPtr>> _done;
+  std::exception_ptr _writerError;
+  std::mutex _errorMutex;
+};
+
+
+#endif
@@ -0,0 +1,233 @@
+#include <OutputPolicyHistograms.h>
+
+#include <CRMCoptions.h>
+#include <CRMCinterface.h>
+
+#include <TFile.h>
+#include <TH1D.h>
+#include <TH2D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+
+OutputPolicyHistograms::OutputPolicyHistograms()
+  : fFile(0),
+    fSqrts(0),
+    fPzSum(0),
+    fESum(0),
+    fNEvents(0)
+{
+}
+
+
+OutputPolicyHistograms::~OutputPolicyHistograms()
+{
+  delete fFile; // also deletes the histograms
+}
+
+
+void
+OutputPolicyHistograms::InitOutput(const CRMCoptions& cfg)
+{
+  // the events are in the frame of the beam momenta (-p, -P), e.g. the
+  // lab frame of a fixed target; xf is taken in the centre-of-mass frame
+  fSqrts = cfg.GetSqrts();
+  fPzSum = cfg.GetProjectileMomentum() + cfg.GetTargetMomentum();
+  fESum = sqrt(fSqrts * fSqrts + fPzSum * fPzSum);
+  fFile = TFile::Open(cfg.GetOutputFileName().c_str(), "RECREATE");
+  if (!fFile || fFile->IsZombie()) {
+    cerr << " Cannot open histogram output file " << cfg.GetOutputFileName() << endl;
+    exit(1);
+  }
+  // the histograms belong to the file
+  ReadConfig(cfg.GetHistConfigName());
+}
+
+
+void
+OutputPolicyHistograms::ReadConfig(const string& fileName)
+{
+  ifstream config(fileName.c_str());
+  if (!config.is_open()) {
+    cerr << " Cannot open histogram definitions " << fileName << endl;
+    exit(1);
+  }
+
+  string line;
+  while (getline(config, line)) {
+    const size_t first = line.find_first_not_of(" \t");
+    if (first == string::npos || line[first] == '#')
+      continue;
+
+    istringstream fields(line);
+    string name;
+    Histogram h;
+    string var[2];
+    int n[2] = { 0, 0 };
+    double low[2] = { 0, 0 };
+    double high[2] = { 0, 0 };
+    bool ok = (fields >> h.fDim) && (h.fDim == 1 || h.fDim == 2) && (fields >> name);
+    for (int d = 0; ok && d < h.fDim; d++) {
+      ok = (fields >> var[d] >> n[d] >> low[d] >> high[d]) && n[d] > 0 && low[d] < high[d];
+      h.fVar[d] = ParseVariable(var[d]);
+      ok = ok && h.fVar[d] != eUnknown;
+    }
+
+    h.fNorm = false;
+    string option;
+    while (ok && fields >> option) {
+      if (option == "norm")
+        h.fNorm = true;
+      else if (option.compare(0, 4, "pdg=") == 0) {
+        istringstream ids(option.substr(4));
+        string id;
+        while (getline(ids, id, ','))
+          h.fPdg.push_back(atoi(id.c_str()));
+      }
+      else
+        ok = false;
+    }
+    if (!ok) {
+      cerr << " Wrong histogram definition in " << fileName << ": " << line << endl;
+      exit(1);
+    }
+
+    h.fPerParticle = (h.fVar[0] < eMult || (h.fDim == 2 && h.fVar[1] < eMult));
+    if (h.fDim == 1)
+      h.fHist = new TH1D(name.c_str(), (name + ";" + var[0]).c_str(), n[0], low[0], high[0]);
+    else
+      h.fHist = new TH2D(name.c_str(), (name + ";" + var[0] + ";" + var[1]).c_str(),
+                         n[0], low[0], high[0], n[1], low[1], high[1]);
+    h.fHist->Sumw2();
+    fHistograms.push_back(h);
+  }
+
+  if (fHistograms.empty()) {
+    cerr << " No histogram defined in " << fileName << endl;
+    exit(1);
+  }
+}
+
+
+OutputPolicyHistograms::EVariable
+OutputPolicyHistograms::ParseVariable(const string& name)
+{
+  if (name == "pt") return ePt;
+  if (name == "xf") return eXF;
+  if (name == "eta") return eEta;
+  if (name == "y") return eY;
+  if (name == "e") return eE;
+  if (name == "pz") return ePz;
+  if (name == "phi") return ePhi;
+  if (name == "mult") return eMult;
+  if (name == "b") return eB;
+  if (name == "typevt") return eTypevt;
+  if (name == "npart") return eNPart;
+  return eUnknown;
+}
+
+
+bool
+OutputPolicyHistograms::IsSelected(const Histogram& h, const int i) const
+{
+  if (gCRMC_data.fPartStatus[i] != 1) // final state only
+    return false;
+  return h.fPdg.empty()
+    || find(h.fPdg.begin(), h.fPdg.end(), gCRMC_data.fPartId[i]) != h.fPdg.end();
+}
+
+
+bool
+OutputPolicyHistograms::GetValue(const EVariable v, const int i, const int mult,
+                                 double& value) const
+{
+  if (v < eMult && i < 0)
+    return false;
+
+  const double px = (i < 0 ? 0 : gCRMC_data.fPartPx[i]);
+  const double py = (i < 0 ? 0 : gCRMC_data.fPartPy[i]);
+  const double pz = (i < 0 ? 0 : gCRMC_data.fPartPz[i]);
+  const double e = (i < 0 ? 0 : gCRMC_data.fPartEnergy[i]);
+  const double pt = sqrt(px * px + py * py);
+
+  switch (v) {
+  case ePt: value = pt; return true;
+  case eXF: value = 2. * (fESum * pz - fPzSum * e) / (fSqrts * fSqrts); return true;
+  case eEta:
+    if (pt == 0) return false;
+    value = asinh(pz / pt);
+    return true;
+  case eY:
+    if (e <= fabs(pz)) return false;
+    value = 0.5 * log((e + pz) / (e - pz));
+    return true;
+  case eE: value = e; return true;
+  case ePz: value = pz; return true;
+  case ePhi: value = atan2(py, px); return true;
+  case eMult: value = mult; return true;
+  case eB: value = gCRMC_data.bimevt; return true;
+  case eTypevt: value = gCRMC_data.typevt; return true;
+  case eNPart: value = gCRMC_data.npjevt + gCRMC_data.ntgevt; return true;
+  default: return false;
+  }
+}
+
+
+void
+OutputPolicyHistograms::FillEvent(const CRMCoptions&, const int)
+{
+  fNEvents++;
+  for (const auto& h : fHistograms) {
+    int mult = 0;
+    for (int i = 0; i < gCRMC_data.fNParticles; i++)
+      if (IsSelected(h, i)) mult++;
+
+    double x[2];
+    if (!h.fPerParticle) {
+      if (!GetValue(h.fVar[0], -1, mult, x[0]))
+        continue;
+      if (h.fDim == 1)
+        h.fHist->Fill(x[0]);
+      else if (GetValue(h.fVar[1], -1, mult, x[1]))
+        ((TH2D*)h.fHist)->Fill(x[0], x[1]);
+      continue;
+    }
+
+    for (int i = 0; i < gCRMC_data.fNParticles; i++) {
+      if (!IsSelected(h, i))
+        continue;
+      if (!GetValue(h.fVar[0], i, mult, x[0]))
+        continue;
+      if (h.fDim == 1)
+        h.fHist->Fill(x[0]);
+      else if (GetValue(h.fVar[1], i, mult, x[1]))
+        ((TH2D*)h.fHist)->Fill(x[0], x[1]);
+    }
+  }
+}
+
+
+void
+OutputPolicyHistograms::CloseOutput(const CRMCoptions&)
+{
+  fFile->cd();
+  for (const auto& h : fHistograms)
+    if (h.fNorm && fNEvents > 0)
+      h.fHist->Scale(1. / fNEvents, "width");
+
+  // for the normalisation of the other histograms
+  TH1D* events = new TH1D("NEvents", "number of events", 1, 0, 1);
+  events->SetBinContent(1, fNEvents);
+
+  fFile->Write();
+  fFile->Close();
+  cout << "OutputPolicyHistograms::CloseOutput() --- " << fHistograms.size()
+       << " histograms of " << fNEvents << " events written to " << fFile->GetName() << endl;
+}
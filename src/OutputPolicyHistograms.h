@@ -0,0 +1,73 @@
+#ifndef _OutputPolicyHistograms_h_
+#define _OutputPolicyHistograms_h_
+#include "OutputPolicyNone.h"
+
+#include <string>
+#include <vector>
+
+class TFile;
+class TH1;
+
+class CRMCoptions;
+
+/**
+ * Fills histograms from gCRMC_data while generating (-o hist) and
+ * writes only the histograms, no events.
+ *
+ * The histograms are defined in a text file (--hist-config), one per
+ * line:
+ *
+ *   1 <name> <x> <nx> <xmin> <xmax> [pdg=<id>,...] [norm]
+ *   2 <name> <x> <nx> <xmin> <xmax> <y> <ny> <ymin> <ymax> [pdg=<id>,...] [norm]
+ *
+ * with the particle quantities pt, xf, eta, y, e, pz, phi and the event
+ * quantities mult, b, typevt, npart (projectile + target participants).
+ * Histograms of particle quantities are filled once per final state
+ * particle, with pdg= for the selected ids, the others once per event
+ * (mult counts the selected particles).  norm divides by the number of
+ * events and the bin width, e.g. for dN/deta.
+ */
+class OutputPolicyHistograms : public OutputPolicyNone {
+
+ public:
+  OutputPolicyHistograms();
+  ~OutputPolicyHistograms() override;
+
+  void InitOutput(const CRMCoptions& cfg) override;
+  void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
+  void CloseOutput(const CRMCoptions& cfg) override;
+
+ private:
+  enum EVariable {
+    // per particle
+    ePt, eXF, eEta, eY, eE, ePz, ePhi,
+    // per event
+    eMult, eB, eTypevt, eNPart,
+    eUnknown
+  };
+
+  struct Histogram {
+    TH1* fHist;
+    int fDim;
+    EVariable fVar[2];
+    std::vector<int> fPdg; // all if empty
+    bool fNorm;
+    bool fPerParticle;
+  };
+
+  void ReadConfig(const std::string& fileName);
+  static EVariable ParseVariable(const std::string& name);
+  bool IsSelected(const Histogram& h, const int i) const;
+  /** Value of v for particle i (-1 for event quantities), false if undefined */
+  bool GetValue(const EVariable v, const int i, const int mult, double& value) const;
+
+  std::vector<Histogram> fHistograms;
+  TFile* fFile;
+  double fSqrts;
+  double fPzSum; // momentum and energy of the beams, for the boost to the CMS
+  double fESum;
+  long long fNEvents;
+};
+
+
+#endif
@@ -28,6 +28,9 @@ OutputPolicyNone::FillEvent(const CRMCoptions& cfg, const int nEvent)
 void 
 OutputPolicyNone::FillRHICfEvent(const CRMCoptions& cfg, const int nEvent, int& passEventNum)
 {
+  // policies without RHICf acceptance keep every collision
+  FillEvent(cfg, nEvent);
+  passEventNum++;
 }
 
 void
@@ -7,6 +7,7 @@ class OutputPolicyNone {
 
 public:
   OutputPolicyNone();
+  virtual ~OutputPolicyNone() {}
 
   virtual void InitOutput(const CRMCoptions& cfg);
   virtual void FillEvent(const CRMCoptions& cfg, const int nEvent);
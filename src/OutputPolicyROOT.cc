@@ -6,6 +6,7 @@
 #include <TTree.h>
 #include <TFile.h>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -21,7 +22,10 @@ OutputPolicyROOT::OutputPolicyROOT()
      fFile(0),
      fHead(0),
      iSigId(0),
-     fParticle(0)
+     fParticle(0),
+     fCopy(false),
+     fFinalOnly(false),
+     fNPart(0)
 {
 }
 
@@ -52,17 +56,54 @@ OutputPolicyROOT::InitOutput(const CRMCoptions& cfg)
     
   // particle list
   fParticle = new TTree("Particle","particles produced");
-  
-  fParticle->Branch("nPart", &gCRMC_data.fNParticles, "nPart/I");
-  fParticle->Branch("ImpactParameter", &gCRMC_data.fImpactParameter, "ImpactParameter/D");
-  fParticle->Branch("ProcessID", &iSigId, "ProcessId/I");
-  fParticle->Branch("pdgid", gCRMC_data.fPartId, "pdgid[nPart]/I");
-  fParticle->Branch("status", gCRMC_data.fPartStatus, "status[nPart]/I");
-  fParticle->Branch("px", gCRMC_data.fPartPx, "px[nPart]/D");
-  fParticle->Branch("py", gCRMC_data.fPartPy, "py[nPart]/D");
-  fParticle->Branch("pz", gCRMC_data.fPartPz, "pz[nPart]/D");
-  fParticle->Branch("E", gCRMC_data.fPartEnergy, "E[nPart]/D");
-  fParticle->Branch("m", gCRMC_data.fPartMass, "m[nPart]/D");
+
+  // the particles are copied only if they are filtered or converted,
+  // otherwise the branches read directly from gCRMC_data
+  fFinalOnly = cfg.fRootFinalOnly;
+  fPrecision = cfg.fRootPrecision;
+  fCopy = fFinalOnly || fPrecision == "float";
+  if (fCopy) {
+    fPdgId.resize(CRMCdata::fMaxParticles);
+    fStatus.resize(CRMCdata::fMaxParticles);
+    for (int k = 0; k < kNMomentum; k++) {
+      if (fPrecision == "float")
+        fFloat[k].resize(CRMCdata::fMaxParticles);
+      else
+        fDouble[k].resize(CRMCdata::fMaxParticles);
+    }
+  }
+  double* momentum[kNMomentum] = {gCRMC_data.fPartPx, gCRMC_data.fPartPy, gCRMC_data.fPartPz,
+                                  gCRMC_data.fPartEnergy, gCRMC_data.fPartMass};
+  const char* momentumName[kNMomentum] = {"px", "py", "pz", "E", "m"};
+  // Double32_t in memory, stored as float with a 16 bit mantissa
+  const string leafType = (fPrecision == "float" ? "F" : fPrecision == "reduced" ? "d[0,0,16]" : "D");
+
+  fParticle->Branch("nPart", fCopy ? &fNPart : &gCRMC_data.fNParticles, "nPart/I");
+  if (IsSelected(cfg, "ImpactParameter"))
+    fParticle->Branch("ImpactParameter", &gCRMC_data.fImpactParameter, "ImpactParameter/D");
+  if (IsSelected(cfg, "ProcessID"))
+    fParticle->Branch("ProcessID", &iSigId, "ProcessId/I");
+  if (IsSelected(cfg, "pdgid"))
+    fParticle->Branch("pdgid", fCopy ? &fPdgId[0] : gCRMC_data.fPartId, "pdgid[nPart]/I");
+  if (IsSelected(cfg, "status"))
+    fParticle->Branch("status", fCopy ? &fStatus[0] : gCRMC_data.fPartStatus, "status[nPart]/I");
+  for (int k = 0; k < kNMomentum; k++) {
+    if (!IsSelected(cfg, momentumName[k]))
+      continue;
+    void* address = momentum[k];
+    if (fCopy)
+      address = (fPrecision == "float" ? (void*)&fFloat[k][0] : (void*)&fDouble[k][0]);
+    const string leaf = string(momentumName[k]) + "[nPart]/" + leafType;
+    fParticle->Branch(momentumName[k], address, leaf.c_str());
+  }
+}
+
+
+bool
+OutputPolicyROOT::IsSelected(const CRMCoptions& cfg, const string& branch) const
+{
+  const vector<string>& selected = cfg.fRootBranches;
+  return selected.empty() || find(selected.begin(), selected.end(), branch) != selected.end();
 }
 
 
@@ -79,8 +120,6 @@ OutputPolicyROOT::FillEvent(const CRMCoptions& cfg,const int nEvent)
     fHead->Fill(); // do only once
   }
 
-
-  std::cout << " gCRMC_data.typevt " << gCRMC_data.typevt << std::endl;
    
   //Process Id
    //an integer ID uniquely specifying the signal process (i.e. MSUB in Pythia)
@@ -109,6 +148,26 @@ OutputPolicyROOT::FillEvent(const CRMCoptions& cfg,const int nEvent)
      }
 
 
+  if (fCopy) {
+    const double* momentum[kNMomentum] = {gCRMC_data.fPartPx, gCRMC_data.fPartPy,
+                                          gCRMC_data.fPartPz, gCRMC_data.fPartEnergy,
+                                          gCRMC_data.fPartMass};
+    fNPart = 0;
+    for (int i = 0; i < gCRMC_data.fNParticles; i++) {
+      if (fFinalOnly && gCRMC_data.fPartStatus[i] != 1)
+        continue;
+      fPdgId[fNPart] = gCRMC_data.fPartId[i];
+      fStatus[fNPart] = gCRMC_data.fPartStatus[i];
+      for (int k = 0; k < kNMomentum; k++) {
+        if (fPrecision == "float")
+          fFloat[k][fNPart] = momentum[k][i];
+        else
+          fDouble[k][fNPart] = momentum[k][i];
+      }
+      fNPart++;
+    }
+  }
+
   fParticle->Fill();
 }
 
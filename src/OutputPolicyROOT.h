@@ -3,6 +3,8 @@
 #include "OutputPolicyNone.h"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 class TTree;
 class TFile;
@@ -20,6 +22,9 @@ class OutputPolicyROOT : public OutputPolicyNone {
 
  protected:
 
+  /** Branch kept by --root-branches (all if none given) */
+  bool IsSelected(const CRMCoptions& cfg, const std::string& branch) const;
+
   double fSigmaPairTot;
   double fSigmaPairInel;
   double fSigmaPairEl;
@@ -31,6 +36,17 @@ class OutputPolicyROOT : public OutputPolicyNone {
   TFile* fFile;
   TTree* fHead;
   TTree* fParticle;
+
+  // ====== particle copies for --root-final-only and --root-precision float =======
+  enum { kNMomentum = 5 }; // px, py, pz, E, m
+  bool fCopy;
+  bool fFinalOnly;
+  std::string fPrecision;
+  int fNPart;
+  std::vector<int> fPdgId;
+  std::vector<int> fStatus;
+  std::vector<double> fDouble[kNMomentum];
+  std::vector<float> fFloat[kNMomentum];
 };
 
 
@@ -5,45 +5,185 @@
 #include <CRMCconfig.h>
 #include <Rivet/Rivet.hh>
 
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+  // the parts are equivalent (equiv=true): cross sections and sums of
+  // weights are averaged, not added.  Newer Rivet versions have the
+  // match/unmatch patterns before the equiv flag, older ones do not
+  template <typename Handler>
+  auto MergeEquivalent(Handler& handler, const vector<string>& files, int)
+    -> decltype(handler.mergeYodas(files, {}, {}, {}, {}, true), void())
+  {
+    handler.mergeYodas(files, {}, {}, {}, {}, true);
+  }
+
+  template <typename Handler>
+  void MergeEquivalent(Handler& handler, const vector<string>& files, long)
+  {
+    handler.mergeYodas(files, {}, {}, true);
+  }
+}
+
 //--------------------------------------------------------------------
 OutputPolicyRivet::OutputPolicyRivet()
 {}
 
+//--------------------------------------------------------------------
+OutputPolicyRivet::~OutputPolicyRivet()
+{
+  StopWorkers();
+}
+
 //--------------------------------------------------------------------
 void OutputPolicyRivet::InitOutput(const CRMCoptions& cfg)
 {
-  _hepmc3.init(cfg);
+  // queued events must not share their header with the next one
+  _hepmc3.init(cfg, cfg.GetRivetThreads() > 0);
 
   for (auto p : cfg.GetRivetSearch()) {
     Rivet::addAnalysisLibPath (p);
     Rivet::addAnalysisDataPath(p);
   }
+
+  const int nThreads = cfg.GetRivetThreads();
+  if (nThreads == 0) {
+    InitHandler(_handler, cfg);
+    return;
+  }
+
+  for (int i = 0; i < nThreads; i++) {
+    _workerHandlers.emplace_back(new Rivet::AnalysisHandler);
+    InitHandler(*_workerHandlers.back(), cfg);
+  }
+  // enough events that the generator does not wait for busy workers
+  const int nEvents = 2 * nThreads + 1;
+  _todo.reset(new CRMCqueue<EventPtr>(nEvents));
+  _done.reset(new CRMCqueue<EventPtr>(nEvents));
+  for (int i = 0; i < nEvents; i++)
+    _done->push(EventPtr(new HepMC3::GenEvent));
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyRivet::InitHandler(Rivet::AnalysisHandler& handler,
+				    const CRMCoptions& cfg)
+{
   for (auto p : cfg.GetRivetPreloads())
-    _handler.readData(p);
-  
-  for (auto a : cfg.GetRivetAnalyses()) 
-    _handler.addAnalysis(a);
+    handler.readData(p);
+
+  for (auto a : cfg.GetRivetAnalyses())
+    handler.addAnalysis(a);
 }
 
 //--------------------------------------------------------------------
 void OutputPolicyRivet::FillEvent(const CRMCoptions& cfg, const int nEvent)
 {
-  if (!_hepevt.convert(_event)) 
+  if (_workerHandlers.empty()) {
+    if (!_hepevt.convert(_event))
+      throw std::runtime_error("!!!Could not read next event");
+
+    _hepmc3.fillInEvent(cfg, nEvent, _event);
+
+    if (not _is_init) _handler.init(_event);
+
+    _is_init = true;
+    _handler.analyze(_event);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_errorMutex);
+    if (_workerError) std::rethrow_exception(_workerError);
+  }
+
+  // take a free event, waits if all are queued or being analysed
+  EventPtr event;
+  _done->pop(event);
+  if (!_hepevt.convert(*event))
     throw std::runtime_error("!!!Could not read next event");
 
-  _hepmc3.fillInEvent(cfg, nEvent, _event);
+  _hepmc3.fillInEvent(cfg, nEvent, *event);
 
-  if (not _is_init) _handler.init(_event);
+  if (not _is_init) StartWorkers(*event);
 
   _is_init = true;
-  _handler.analyze(_event);
+  _todo->push(std::move(event));
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyRivet::StartWorkers(const HepMC3::GenEvent& first)
+{
+  // Rivet loads the analyses when initialising, done one at a time
+  for (auto& handler : _workerHandlers)
+    handler->init(first);
+
+  for (auto& handler : _workerHandlers)
+    _workers.emplace_back(&OutputPolicyRivet::Work, this, std::ref(*handler));
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyRivet::Work(Rivet::AnalysisHandler& handler)
+{
+  EventPtr event;
+  while (_todo->pop(event)) {
+    try {
+      handler.analyze(*event);
+    }
+    catch (...) {
+      // reported by the generator thread, keep the events flowing
+      std::lock_guard<std::mutex> lock(_errorMutex);
+      if (!_workerError) _workerError = std::current_exception();
+    }
+    _done->push(std::move(event));
+  }
+}
+
+//--------------------------------------------------------------------
+void OutputPolicyRivet::StopWorkers()
+{
+  if (_todo) _todo->close();
+  for (auto& worker : _workers)
+    worker.join();
+  _workers.clear();
 }
 
 //--------------------------------------------------------------------
 void OutputPolicyRivet::CloseOutput(const CRMCoptions& cfg)
 {
-  _handler.finalize();
-  _handler.writeData(cfg.GetOutputFileName());
+  if (_workerHandlers.empty()) {
+    _handler.finalize();
+    _handler.writeData(cfg.GetOutputFileName());
+    return;
+  }
+
+  StopWorkers();
+  if (_workerError) std::rethrow_exception(_workerError);
+  if (not _is_init) {
+    cerr << " No event was given to Rivet, nothing written" << endl;
+    return;
+  }
+
+  // each worker saw a statistically independent part of the run
+  vector<string> parts;
+  for (size_t i = 0; i < _workerHandlers.size(); i++) {
+    ostringstream part;
+    part << cfg.GetOutputFileName() << ".worker" << i << ".yoda";
+    _workerHandlers[i]->finalize();
+    _workerHandlers[i]->writeData(part.str());
+    parts.push_back(part.str());
+  }
+
+  Rivet::AnalysisHandler merged;
+  MergeEquivalent(merged, parts, 0);
+  merged.writeData(cfg.GetOutputFileName());
+
+  for (const auto& part : parts)
+    std::remove(part.c_str());
 }
 
 
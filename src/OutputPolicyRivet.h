@@ -7,27 +7,63 @@
 #include <Rivet/AnalysisHandler.hh>
 #include <OutputPolicyNone.h>
 #include "CRMChepevt.h"
+#include "CRMCarena.h"
 #include "CRMChepmc3.h"
+#include "CRMCqueue.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 class CRMCoptions;
 
+/**
+ * Runs Rivet analyses on the generated events.
+ *
+ * With --rivet-threads N the analysis is done by N worker threads,
+ * each with its own AnalysisHandler, taking converted events from a
+ * queue.  Their results are merged into one YODA file at the end (as
+ * rivet-merge does for separate runs).
+ */
 class OutputPolicyRivet : public OutputPolicyNone
 {
 public:
   OutputPolicyRivet();
+  ~OutputPolicyRivet() override;
   void InitOutput(const CRMCoptions& cfg) override;
   void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
   void CloseOutput(const CRMCoptions& cfg) override;
 private:
+  using EventPtr=std::unique_ptr<HepMC3::GenEvent>;
+
+  void InitHandler(Rivet::AnalysisHandler& handler, const CRMCoptions& cfg);
+  void StartWorkers(const HepMC3::GenEvent& first);
+  void Work(Rivet::AnalysisHandler& handler);
+  void StopWorkers();
+
   CRMChepevt<HepMC3::GenParticlePtr,
 	     HepMC3::GenVertexPtr,
 	     HepMC3::FourVector,
-	     HepMC3::GenEvent> _hepevt;
+	     HepMC3::GenEvent,
+	     CRMCarenaFactory<HepMC3::GenParticlePtr,
+	                      HepMC3::GenVertexPtr,
+	                      HepMC3::FourVector>> _hepevt;
   CRMChepmc3 _hepmc3;
   HepMC3::GenEvent _event;
   Rivet::AnalysisHandler _handler;
   bool _is_init = false;
+
+  // ====== worker threads (--rivet-threads) =======
+  std::vector<std::unique_ptr<Rivet::AnalysisHandler>> _workerHandlers;
+  std::vector<std::thread> _workers;
+  /** Converted events waiting for a worker */
+  std::unique_ptr<CRMCqueue<EventPtr>> _todo;
+  /** Analysed events, ready to be filled again */
+  std::unique_ptr<CRMCqueue<EventPtr>> _done;
+  std::exception_ptr _workerError;
+  std::mutex _errorMutex;
 };
 
 
 #endif
-
@@ -0,0 +1,186 @@
+#include <OutputPolicySharedMemory.h>
+
+#include <CRMCoptions.h>
+#include <CRMCinterface.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <CRMCconfig.h> //cmake generated
+
+using namespace std;
+using namespace CRMCshm;
+
+static_assert(CRMCdata::fMaxParticles == kMaxParticles,
+              "shared memory slots must hold all particles of CRMCdata");
+
+
+namespace {
+  void
+  Wait()
+  {
+    struct timespec ts = {0, kWaitNanoSeconds};
+    nanosleep(&ts, 0);
+  }
+}
+
+
+OutputPolicySharedMemory::OutputPolicySharedMemory()
+  : fHeader(0),
+    fSize(0),
+    fTimeout(0)
+{
+}
+
+
+OutputPolicySharedMemory::~OutputPolicySharedMemory()
+{
+  if (fHeader)
+    munmap(fHeader, fSize);
+}
+
+
+string
+OutputPolicySharedMemory::GetSegmentName(const CRMCoptions& cfg)
+{
+  if (cfg.IsOutputFileNameSet()) {
+    const string name = cfg.GetOutputFileName();
+    return name[0] == '/' ? name : "/" + name;
+  }
+  ostringstream name;
+  name << "/crmc_" << cfg.GetSeed();
+  return name.str();
+}
+
+
+void
+OutputPolicySharedMemory::InitOutput(const CRMCoptions& cfg)
+{
+  fName = GetSegmentName(cfg);
+  fSize = SegmentSize(cfg.GetShmSlots());
+  fTimeout = cfg.GetShmTimeout();
+
+  shm_unlink(fName.c_str()); // left over from an aborted run
+  const int fd = shm_open(fName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0 || ftruncate(fd, fSize) != 0) {
+    cerr << " Cannot create shared memory segment " << fName << ": "
+         << strerror(errno) << endl;
+    exit(1);
+  }
+  void* mem = mmap(0, fSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    cerr << " Cannot map shared memory segment " << fName << ": "
+         << strerror(errno) << endl;
+    shm_unlink(fName.c_str());
+    exit(1);
+  }
+
+  // ftruncate gives zeroed pages, only the non-zero fields are set
+  fHeader = static_cast<CRMCshmHeader*>(mem);
+  fHeader->fVersion = kVersion;
+  fHeader->fNSlots = cfg.GetShmSlots();
+  fHeader->fMaxParticles = kMaxParticles;
+  fHeader->fSlotSize = sizeof(CRMCshmSlot);
+  fHeader->fSeed = cfg.GetSeed();
+  fHeader->fHEModel = cfg.GetHEModel();
+  fHeader->fProjectileId = cfg.GetProjectileId();
+  fHeader->fTargetId = cfg.GetTargetId();
+  fHeader->fProjectileMomentum = cfg.GetProjectileMomentum();
+  fHeader->fTargetMomentum = cfg.GetTargetMomentum();
+  fHeader->fSqrts = cfg.GetSqrts();
+  fHeader->fProducerPid = getpid();
+  fHeader->fMagic.store(kMagic, std::memory_order_release);
+
+  cout << " Events are published in shared memory " << fName
+       << " (" << cfg.GetShmSlots() << " slots)" << endl;
+}
+
+
+void
+OutputPolicySharedMemory::FillEvent(const CRMCoptions& cfg, const int nEvent)
+{
+  const uint64_t iWrite = fHeader->fWriteIndex.load(std::memory_order_relaxed);
+
+  // back-pressure: wait for the consumer to free a slot
+  long nPolls = 0;
+  double since = Seconds();
+  while (iWrite - fHeader->fReadIndex.load(std::memory_order_acquire) >= fHeader->fNSlots)
+    WaitForConsumer(nPolls, since);
+
+  CRMCshmSlot* slot = GetSlot(fHeader, iWrite);
+  const int n = gCRMC_data.fNParticles;
+  slot->fEventNumber = nEvent;
+  slot->fTypevt = gCRMC_data.typevt;
+  slot->fNpjevt = gCRMC_data.npjevt;
+  slot->fNtgevt = gCRMC_data.ntgevt;
+  slot->fKolevt = gCRMC_data.kolevt;
+  slot->fNParticles = n;
+  slot->fImpactParameter = gCRMC_data.fImpactParameter;
+  slot->fSigmaInel = gCRMC_data.sigine;
+  slot->fSigmaInelAA = gCRMC_data.sigineaa;
+  memcpy(slot->fPartId, gCRMC_data.fPartId, n * sizeof(int32_t));
+  memcpy(slot->fPartStatus, gCRMC_data.fPartStatus, n * sizeof(int32_t));
+  memcpy(slot->fPartPx, gCRMC_data.fPartPx, n * sizeof(double));
+  memcpy(slot->fPartPy, gCRMC_data.fPartPy, n * sizeof(double));
+  memcpy(slot->fPartPz, gCRMC_data.fPartPz, n * sizeof(double));
+  memcpy(slot->fPartEnergy, gCRMC_data.fPartEnergy, n * sizeof(double));
+  memcpy(slot->fPartMass, gCRMC_data.fPartMass, n * sizeof(double));
+
+  // publish the slot
+  fHeader->fWriteIndex.store(iWrite + 1, std::memory_order_release);
+}
+
+
+void
+OutputPolicySharedMemory::CloseOutput(const CRMCoptions& cfg)
+{
+  fHeader->fClosed.store(1, std::memory_order_release);
+
+  const uint64_t nWritten = fHeader->fWriteIndex.load(std::memory_order_relaxed);
+  if (fHeader->fReadIndex.load(std::memory_order_acquire) < nWritten)
+    cout << " Waiting for the consumer to read the last events from " << fName << endl;
+  long nPolls = 0;
+  double since = Seconds();
+  while (fHeader->fReadIndex.load(std::memory_order_acquire) < nWritten)
+    WaitForConsumer(nPolls, since);
+
+  // the consumer keeps its mapping, only the name is removed
+  shm_unlink(fName.c_str());
+  munmap(fHeader, fSize);
+  fHeader = 0;
+}
+
+
+void
+OutputPolicySharedMemory::WaitForConsumer(long& nPolls, double& since)
+{
+  Wait();
+  if (++nPolls % kPollsPerCheck)
+    return;
+
+  // a slow consumer is waited for, a dead or missing one is not
+  const int32_t pid = fHeader->fConsumerPid.load(std::memory_order_acquire);
+  if (pid && IsRunning(pid)) {
+    since = Seconds();
+    return;
+  }
+  if (pid)
+    cerr << " The consumer (pid " << pid << ") of " << fName
+         << " has ended without reading all events" << endl;
+  else if (fTimeout > 0 && Seconds() - since > fTimeout)
+    cerr << " No consumer has read from " << fName << " for "
+         << fTimeout << " s" << endl;
+  else
+    return;
+  shm_unlink(fName.c_str());
+  exit(1);
+}
@@ -0,0 +1,44 @@
+#ifndef _OutputPolicySharedMemory_h_
+#define _OutputPolicySharedMemory_h_
+#include "OutputPolicyNone.h"
+#include "CRMCshm.h"
+
+#include <string>
+
+class CRMCoptions;
+
+/**
+ * Publishes the events into a POSIX shared-memory ring buffer
+ * (see CRMCshm.h) for a consumer running on the same node, e.g. a
+ * detector simulation using CRMCshmReader.
+ *
+ * When all slots are taken the generation waits for the consumer,
+ * and CloseOutput only returns once the consumer has read every event.
+ * Both waits end with an error if the consumer has died, or if none
+ * is attached for --shm-timeout seconds.
+ */
+class OutputPolicySharedMemory : public OutputPolicyNone {
+
+ public:
+  OutputPolicySharedMemory();
+  ~OutputPolicySharedMemory() override;
+
+  void InitOutput(const CRMCoptions& cfg) override;
+  void FillEvent(const CRMCoptions& cfg, const int nEvent) override;
+  void CloseOutput(const CRMCoptions& cfg) override;
+
+  /** Name of the segment, "/crmc_<seed>" if no file name is given */
+  static std::string GetSegmentName(const CRMCoptions& cfg);
+
+ private:
+  /** One poll of a wait for the consumer, exits if it is gone */
+  void WaitForConsumer(long& nPolls, double& since);
+
+  std::string fName;
+  CRMCshm::CRMCshmHeader* fHeader;
+  unsigned long long fSize;
+  double fTimeout;
+};
+
+
+#endif
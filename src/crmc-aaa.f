@@ -37,6 +37,27 @@ c 15.01.2009 Simplified Main program and random number generator for epos
 
 
       if(init.eq.0)then     !security just to be sure it is called once only
+
+c     Particle list in huge pages with CRMC_HUGEPAGES=on, before it is
+c     used (see src/tabcache/HugePages.h)
+      call HugePages(loc(pptl),sizeof(pptl))
+      call HugePages(loc(iorptl),sizeof(iorptl))
+      call HugePages(loc(idptl),sizeof(idptl))
+      call HugePages(loc(istptl),sizeof(istptl))
+      call HugePages(loc(tivptl),sizeof(tivptl))
+      call HugePages(loc(ifrptl),sizeof(ifrptl))
+      call HugePages(loc(jorptl),sizeof(jorptl))
+      call HugePages(loc(xorptl),sizeof(xorptl))
+      call HugePages(loc(ibptl),sizeof(ibptl))
+      call HugePages(loc(ityptl),sizeof(ityptl))
+      call HugePages(loc(itsptl),sizeof(itsptl))
+      call HugePages(loc(iaaptl),sizeof(iaaptl))
+      call HugePages(loc(radptl),sizeof(radptl))
+      call HugePages(loc(desptl),sizeof(desptl))
+      call HugePages(loc(dezptl),sizeof(dezptl))
+      call HugePages(loc(rinptl),sizeof(rinptl))
+      call HugePages(loc(qsqptl),sizeof(qsqptl))
+      call HugePages(loc(zpaptl),sizeof(zpaptl))
         
 c     Set parameters to default value
       call aaset(0)
@@ -284,6 +305,28 @@ c     Update some parameters value to run correctly
 
       end
 
+      subroutine crmc_reseed_f(iSeed)
+
+***************************************************************
+*
+*  restart the random number sequence of the event simulation
+*  with seed iSeed, before generating an event
+*
+*   input: iSeed      - seed (0 < iSeed < 1e9)
+*
+*  the next event only depends on iSeed (and on the initialization),
+*  not on the events generated before.
+***************************************************************
+      implicit none
+      include "epos.inc"
+      integer iSeed
+
+      seedj=dble(iSeed)
+      call ranfcv(0d0)          !reset the counters of the sequence
+      call ranfini(seedj,iseqsim,2)
+
+      end
+
       subroutine crmc_f(iout,ievent,noutpart,impactpar,outpart,outpx
      +                  ,outpy,outpz,oute,outm,outstat)
 
@@ -311,22 +354,19 @@ c     Output quantities
       double precision oute(*), outm(*)
       integer outstat(*)
 
-      double precision boostvec1,boostvec2,boostvec3,boostvec4,boostvec5
-      double precision mass,ppp,xcount
-      double precision ycm2det
-      logical doBoost
-      common/boostvars/ycm2det,doBoost
+      double precision xcount,xneg
       data xcount / 0d0 /
       save
 
-      integer i!,k
-
 c     Calculate an inelastic event
       call aepos(-1)
 
 c     Fix final particles and some event parameters
       call afinal
 
+c     Keep the links changed by hepmcstore (see crmc_store_f)
+      call crmcptl(1)
+
 c     Fill HEP common
       call hepmcstore(iout)  !use hepmcstore for all models to be sure to get same vertex structure
 c      call xInvMass(ievent)          !invariant mass distribution
@@ -341,6 +381,110 @@ c     Print out (same as the one defined in input.optns)
         print *,'          increase nmxhep : ',nhep,' > ',nmxhep
 c        stop
       endif
+      call crmcout(noutpart,impactpar,outpart,outpx,outpy,outpz
+     +             ,oute,outm,outstat,xneg)
+      xcount=xcount+xneg
+      if(ievent.eq.nevent)then
+        if(xcount.gt.0d0)print *,
+     +       'Warning : negative mass for ',xcount,' particles !'
+        if(model.le.1)call hnbdestroy
+      endif
+
+c     Write lhe file
+      if(iout.eq.1)call lhesave(ievent)
+
+      end
+
+      subroutine crmc_store_f(iout,noutpart,impactpar,outpart,outpx
+     +                  ,outpy,outpz,oute,outm,outstat)
+
+***************************************************************
+*
+*  fill the HEP common and the output arrays again from the event
+*  of the last crmc_f call, for another output type (e.g. -1 for a
+*  ROOT sink of a HepMC run)
+*
+*   input:  iout      - output type (not 1, no LHE output)
+*   output: as crmc_f
+*
+***************************************************************
+      implicit none
+      include "epos.inc"
+      integer noutpart,iout
+      double precision impactpar
+      integer outpart(*)
+      double precision outpx(*), outpy(*), outpz(*)
+      double precision oute(*), outm(*)
+      integer outstat(*)
+      double precision xneg
+
+c     hepmcstore changes the links of the particle list
+      call crmcptl(2)
+      call hepmcstore(iout)
+      call crmcout(noutpart,impactpar,outpart,outpx,outpy,outpz
+     +             ,oute,outm,outstat,xneg)
+
+      end
+
+      subroutine crmcptl(mode)
+
+***************************************************************
+*
+*  mode 1 : save the mother and daughter links of the particle list
+*  mode 2 : restore them
+*
+***************************************************************
+      implicit none
+      include "epos.inc"
+      integer mode,i
+      integer iorsav(mxptl),jorsav(mxptl),ifrsav(2,mxptl)
+      save iorsav,jorsav,ifrsav
+
+      do i=1,nptl
+        if(mode.eq.1)then
+          iorsav(i)=iorptl(i)
+          jorsav(i)=jorptl(i)
+          ifrsav(1,i)=ifrptl(1,i)
+          ifrsav(2,i)=ifrptl(2,i)
+        else
+          iorptl(i)=iorsav(i)
+          jorptl(i)=jorsav(i)
+          ifrptl(1,i)=ifrsav(1,i)
+          ifrptl(2,i)=ifrsav(2,i)
+        endif
+      enddo
+
+      end
+
+      subroutine crmcout(noutpart,impactpar,outpart,outpx
+     +                  ,outpy,outpz,oute,outm,outstat,xneg)
+
+***************************************************************
+*
+*  copy the HEP common to the output arrays (see crmc_f), in
+*  the detector frame
+*
+*   output: xneg      - number of particles off their mass shell
+*
+***************************************************************
+      implicit none
+      include "epos.inc"
+      integer noutpart
+      double precision impactpar
+      integer outpart(*)
+      double precision outpx(*), outpy(*), outpz(*)
+      double precision oute(*), outm(*)
+      integer outstat(*)
+
+      double precision boostvec1,boostvec2,boostvec3,boostvec4,boostvec5
+      double precision mass,ppp,xneg
+      double precision ycm2det
+      logical doBoost
+      common/boostvars/ycm2det,doBoost
+
+      integer i!,k
+
+      xneg=0d0
       noutpart=nhep
       impactpar=dble(bimevt)
 c     define vec to boost from cm. to cms frame
@@ -355,7 +499,7 @@ c Put particle is on-shell (needed because of single/double precision pb)
           ppp  = sqrt( phep(1,i)**2 + phep(2,i)**2 + phep(3,i)**2)
           mass = (phep(4,i)+ppp)*(phep(4,i)-ppp)
           if(abs(mass-phep(5,i)**2)/max(1d2,ppp**2).gt.1d-3)   !not to count precision problems
-     +         xcount=xcount+1d0
+     +         xneg=xneg+1d0
           mass = phep(5,i)      !use the true mass to avoid precision problem
 c          if(abs(mass-phep(5,i)**2)/max(1d2,ppp**2).gt.1d-4)then
 c            print *,mass,phep(5,i)**2,ppp,idhep(i)
@@ -384,14 +528,6 @@ c         write(*,'(i5,3x,i2,2x,2i5,2x,2i5)')i,isthep(i)
 c     *        ,jmohep(1,i),jmohep(2,i),jdahep(1,i),jdahep(2,i)
 c         write(*,'(i10,1x,4(e12.6,1x))')idhep(i),(phep(k,i),k=1,4)
       enddo
-      if(ievent.eq.nevent)then
-        if(xcount.gt.0d0)print *,
-     +       'Warning : negative mass for ',xcount,' particles !'
-        if(model.le.1)call hnbdestroy
-      endif
-
-c     Write lhe file
-      if(iout.eq.1)call lhesave(ievent)
 
       end
 
@@ -1,10 +1,14 @@
 #include <CRMCoptions.h>
 #include <CRMC.h>
+#include <CRMCprefetch.h>
+#include <CRMCprofiler.h>
 #ifdef WITH_ROOT
 #include <OutputPolicyROOT.h>
+#include <OutputPolicyHistograms.h>
 #endif
 #ifdef WITH_HEPMC3
 #include <OutputPolicyHepMC3.h>
+#include <OutputPolicyHepMC3File.h>
 #endif
 #ifdef WITH_HEPMC
 #include <OutputPolicyHepMC.h>
@@ -13,7 +17,9 @@
 #include <OutputPolicyRivet.h>
 #endif
 #include <OutputPolicyLHE.h>
+#include <OutputPolicySharedMemory.h>
 #include <OutputPolicyNone.h>
+#include <OutputPolicyComposite.h>
 
 #include <iostream>
 #include <fstream>
@@ -23,25 +29,22 @@ using namespace std;
 
 
 
-int
-main(int argc, char **argv)
+OutputPolicyNone*
+CreateOutputPolicy(const CRMCoptions::EOutputMode mode)
 {
-
-  const CRMCoptions cfg(argc, argv);
-  if (cfg.OptionsError()){
-    cout << "\nConfiguration Error\n" << endl;
-    return 2;
-  }
-
   OutputPolicyNone* output = 0;
-  
-  switch(cfg.GetOutputMode()) {
+
+  switch(mode) {
 
 
 #ifdef WITH_ROOT
   case CRMCoptions::eROOT:
     output = new OutputPolicyROOT;
     break;
+
+  case CRMCoptions::eHistograms:
+    output = new OutputPolicyHistograms;
+    break;
 #endif
 
 #ifdef WITH_HEPMC
@@ -56,6 +59,12 @@ main(int argc, char **argv)
   case CRMCoptions::eHepMC3GZ:
     output = new OutputPolicyHepMC3;
     break;
+
+  case CRMCoptions::eHepMC3File:
+  case CRMCoptions::eHepMC3FileGZ:
+  case CRMCoptions::eHepMC3Root:
+    output = new OutputPolicyHepMC3File;
+    break;
 #endif
 
 #ifdef WITH_RIVET
@@ -69,15 +78,51 @@ main(int argc, char **argv)
     output = new OutputPolicyLHE;
     break;
 
+  case CRMCoptions::eSharedMemory:
+    output = new OutputPolicySharedMemory;
+    break;
+
   case CRMCoptions::eNone:
     output = new OutputPolicyNone;
     break;
 
   }
+  return output;
+}
+
+
+int
+main(int argc, char **argv)
+{
+
+  // the tables are read from the disk while the options and the model library are loaded
+  CRMCprefetch::Get().Start(argc, argv);
+  CRMCprofiler::Get().Phase("options");
+  const CRMCoptions cfg(argc, argv);
+  if (cfg.OptionsError()){
+    cout << "\nConfiguration Error\n" << endl;
+    return 2;
+  }
+
+  OutputPolicyNone* output = CreateOutputPolicy(cfg.GetOutputMode());
   if (!output) {
     std::cerr << "Invalid output policy specified" << std::endl;
     return 1;
   }
+
+  if (!cfg.GetOutputSinks().empty()) {
+    OutputPolicyComposite* composite = new OutputPolicyComposite;
+    composite->AddSink(output, cfg);
+    for (const auto& sink : cfg.GetOutputSinks()) {
+      OutputPolicyNone* sinkOutput = CreateOutputPolicy(sink.fMode);
+      if (!sinkOutput) {
+        std::cerr << "Invalid output sink specified" << std::endl;
+        return 1;
+      }
+      composite->AddSink(sinkOutput, cfg.ForOutputSink(sink));
+    }
+    output = composite;
+  }
   
   CRMC crmc(cfg, *output);
   if (!crmc.init())   return 1;
@@ -0,0 +1,296 @@
+/**
+ * crmc-merge: merges RHICfSimGenerator files (e.g. the shards of many
+ * jobs) into one file.
+ *
+ * The Event and Summary trees are merged in parallel: every thread
+ * fast-clones the baskets of a contiguous part of the inputs into a
+ * partial file, the partial files are then fast-cloned in order into the
+ * output.  The entries of the Run trees are checked (same run type and
+ * model everywhere, no seed and shard used twice) and copied, one entry
+ * per merged shard, so the totals are always the sums over the Run tree.
+ */
+#include <CRMCconfig.h>
+
+#include <TChain.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include <tclap/CmdLine.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+  struct RunEntry {
+    int fRHICfRunType;
+    int fModelType;
+    int fSeed;
+    int fShardIndex;
+    int fNCollision;
+    int fNAccepted;
+  };
+
+  struct InputFile {
+    string fName;
+    bool fOk = false;
+    bool fHasEvent = false;
+    long long fNSummary = 0;
+    vector<RunEntry> fRun;
+  };
+
+
+  void
+  ScanInput(InputFile& in)
+  {
+    TFile* file = TFile::Open(in.fName.c_str(), "read");
+    if (!file || file->IsZombie()) {
+      delete file;
+      return;
+    }
+
+    TTree* run = 0;
+    TTree* summary = 0;
+    file->GetObject("Run", run);
+    file->GetObject("Summary", summary);
+    if (run && summary) {
+      RunEntry e;
+      run->SetBranchAddress("RHICfRunType", &e.fRHICfRunType);
+      run->SetBranchAddress("ModelType", &e.fModelType);
+      run->SetBranchAddress("Seed", &e.fSeed);
+      run->SetBranchAddress("ShardIndex", &e.fShardIndex);
+      run->SetBranchAddress("NCollision", &e.fNCollision);
+      run->SetBranchAddress("NAccepted", &e.fNAccepted);
+      for (Long64_t i = 0; i < run->GetEntries(); i++) {
+        run->GetEntry(i);
+        in.fRun.push_back(e);
+      }
+      in.fNSummary = summary->GetEntries();
+      in.fHasEvent = (file->Get("Event") != 0);
+      in.fOk = true;
+    }
+    delete file; // also deletes the trees
+  }
+
+
+  /** Fast-clones the trees of the files into output, false on errors */
+  bool
+  MergeTrees(const vector<string>& files, const string& output, const bool hasEvent)
+  {
+    TFile out(output.c_str(), "recreate");
+    if (out.IsZombie())
+      return false;
+
+    vector<string> names = { "Summary" };
+    if (hasEvent)
+      names.push_back("Event");
+    for (const auto& name : names) {
+      TChain chain(name.c_str());
+      for (const auto& f : files)
+        chain.Add(f.c_str());
+      if (chain.Merge(&out, 0, "fast keep") <= 0)
+        return false;
+    }
+
+    if (hasEvent) {
+      // as in the generator files, e.g. Event->Draw("...", "Summary.NFinal > 10")
+      TTree* event = 0;
+      out.GetObject("Event", event);
+      event->AddFriend("Summary");
+      event->Write("", TObject::kOverwrite);
+    }
+    out.Close();
+    return true;
+  }
+
+
+  /** Runs job(i) for i < n on up to nThreads threads */
+  template <typename Job>
+  void
+  ForEach(const int n, const int nThreads, Job job)
+  {
+    vector<thread> threads;
+    for (int t = 0; t < nThreads; t++)
+      threads.emplace_back([=]() { for (int i = t; i < n; i += nThreads) job(i); });
+    for (auto& t : threads)
+      t.join();
+  }
+
+}
+
+
+int
+main(int argc, char** argv)
+{
+  string outputName;
+  vector<string> inputNames;
+  int nThreads = 1;
+
+  try {
+    ostringstream vers;
+    vers << CRMC_VERSION_MAJOR << "." << CRMC_VERSION_MINOR << "." << CRMC_VERSION_PATCH;
+    TCLAP::CmdLine cmd("Merges RHICfSimGenerator files of crmc", ' ', vers.str());
+
+    TCLAP::ValueArg<string> output("o", "output", "merged file", true, "", "string");
+    cmd.add(output);
+    TCLAP::ValueArg<int> threads(
+        "j", "threads", "number of threads (0: all cores)", false, 0, "int");
+    cmd.add(threads);
+    TCLAP::ValueArg<string> list(
+        "l", "list", "file with the input file names, one per line", false, "", "string");
+    cmd.add(list);
+    TCLAP::UnlabeledMultiArg<string> inputs("inputs", "input files", false, "string");
+    cmd.add(inputs);
+
+    cmd.parse(argc, argv);
+
+    outputName = output.getValue();
+    inputNames = inputs.getValue();
+    if (!list.getValue().empty()) {
+      ifstream listFile(list.getValue().c_str());
+      if (!listFile.is_open()) {
+        cerr << " Cannot open input list " << list.getValue() << endl;
+        exit(1);
+      }
+      string name;
+      while (listFile >> name)
+        inputNames.push_back(name);
+    }
+    nThreads = threads.getValue();
+    if (nThreads < 0) {
+      cerr << " Number of threads must not be negative" << endl;
+      exit(1);
+    }
+  }
+  catch (TCLAP::ArgException& e) {
+    cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
+    exit(1);
+  }
+
+  if (inputNames.empty()) {
+    cerr << " No input files" << endl;
+    exit(1);
+  }
+  if (nThreads == 0)
+    nThreads = max(1u, thread::hardware_concurrency());
+  const int nInputs = int(inputNames.size());
+  nThreads = min(nThreads, nInputs);
+  ROOT::EnableThreadSafety();
+
+  // the Run trees first, nothing is written if the inputs do not fit together
+  vector<InputFile> inputs(nInputs);
+  for (int i = 0; i < nInputs; i++)
+    inputs[i].fName = inputNames[i];
+  ForEach(nInputs, nThreads, [&](int i) { ScanInput(inputs[i]); });
+
+  bool ok = true;
+  set<pair<int, int> > seeds; // seed, shard index
+  long long nCollision = 0;
+  long long nAccepted = 0;
+  const InputFile* first = 0;
+  for (const auto& in : inputs) {
+    if (!in.fOk || in.fRun.empty()) {
+      cerr << " " << in.fName << " is no RHICfSimGenerator file" << endl;
+      ok = false;
+      continue;
+    }
+    if (!first)
+      first = &in;
+
+    long long nFile = 0;
+    for (const auto& e : in.fRun) {
+      if (e.fRHICfRunType != first->fRun[0].fRHICfRunType) {
+        cerr << " " << in.fName << ": RHICf run type " << e.fRHICfRunType << " instead of "
+             << first->fRun[0].fRHICfRunType << " (" << first->fName << ")" << endl;
+        ok = false;
+      }
+      if (e.fModelType != first->fRun[0].fModelType) {
+        cerr << " " << in.fName << ": model " << e.fModelType << " instead of "
+             << first->fRun[0].fModelType << " (" << first->fName << ")" << endl;
+        ok = false;
+      }
+      if (!seeds.insert(make_pair(e.fSeed, e.fShardIndex)).second) {
+        cerr << " " << in.fName << ": seed " << e.fSeed << " shard " << e.fShardIndex
+             << " is merged twice, the events would not be independent" << endl;
+        ok = false;
+      }
+      nCollision += e.fNCollision;
+      nAccepted += e.fNAccepted;
+      nFile += e.fNAccepted;
+    }
+    if (in.fHasEvent != first->fHasEvent) {
+      cerr << " " << in.fName << ": cannot merge files with and without Event tree (--seeds-only)"
+           << endl;
+      ok = false;
+    }
+    if (nFile != in.fNSummary) {
+      cerr << " " << in.fName << ": " << in.fNSummary << " events instead of " << nFile
+           << " (NAccepted), file not complete?" << endl;
+      ok = false;
+    }
+  }
+  if (!ok) {
+    cerr << " Nothing merged" << endl;
+    exit(1);
+  }
+
+  // contiguous parts keep the order of the events
+  vector<string> partNames;
+  vector<vector<string> > parts(nThreads);
+  for (int t = 0; t < nThreads; t++) {
+    for (int i = t * nInputs / nThreads; i < (t + 1) * nInputs / nThreads; i++)
+      parts[t].push_back(inputNames[i]);
+    partNames.push_back(nThreads == 1 ? outputName
+                        : outputName + ".part" + to_string(t));
+  }
+  vector<char> partOk(nThreads, 0);
+  ForEach(nThreads, nThreads, [&](int t) {
+    partOk[t] = MergeTrees(parts[t], partNames[t], first->fHasEvent);
+  });
+  ok = (count(partOk.begin(), partOk.end(), 0) == 0);
+  if (ok && nThreads > 1)
+    ok = MergeTrees(partNames, outputName, first->fHasEvent);
+  if (nThreads > 1)
+    for (const auto& p : partNames)
+      remove(p.c_str());
+  if (!ok) {
+    cerr << " Cannot merge into " << outputName << endl;
+    remove(outputName.c_str());
+    exit(1);
+  }
+
+  // one Run entry per shard, as in the inputs
+  TFile out(outputName.c_str(), "update");
+  TTree* run = new TTree("Run", "Run"); // belongs to the file
+  RunEntry e;
+  run->Branch("RHICfRunType", &e.fRHICfRunType, "RHICfRunType/I");
+  run->Branch("ModelType", &e.fModelType, "ModelType/I");
+  run->Branch("Seed", &e.fSeed, "Seed/I");
+  run->Branch("ShardIndex", &e.fShardIndex, "ShardIndex/I");
+  run->Branch("NCollision", &e.fNCollision, "NCollision/I");
+  run->Branch("NAccepted", &e.fNAccepted, "NAccepted/I");
+  for (const auto& in : inputs)
+    for (const auto& entry : in.fRun) {
+      e = entry;
+      run->Fill();
+    }
+  run->Write();
+  out.Close();
+
+  cout << " ==[crmc-merge]==> " << nInputs << " files (" << seeds.size() << " shards, "
+       << nCollision << " collisions, " << nAccepted << " events) merged into " << outputName
+       << endl;
+  return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * crmc-mktables: computes the missing tables of the models before the
+ * production, instead of at the start of the first crmc run.
+ *
+ * Every model is initialized with table production switched on, in a
+ * process of its own (the Fortran initialization runs once per process).
+ * The models run one after the other, since they share the EPOS tables;
+ * within a model the independent table cells are computed by
+ * CRMC_TABLE_JOBS worker processes (see src/tabcache/TabFork.h). The
+ * tables are written to <name>.tmp and renamed when complete, so
+ * running jobs never read half-written tables.
+ */
+#include <CRMCconfig.h>
+#include <CRMCinterface.h>
+
+#include <tclap/CmdLine.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+  /** Initializes the model and thereby writes its missing tables, in a child process */
+  bool
+  MakeTables(const int model, const double sqrts, const string& paramFile)
+  {
+    cout << " ==[crmc-mktables]==> model " << model << endl;
+    const pid_t pid = fork();
+    if (pid < 0) {
+      cerr << " Cannot start the initialization of model " << model << endl;
+      return false;
+    }
+    if (pid == 0) {
+      try {
+        CRMCinterface interface;
+        interface.init(model);
+        const int seed = 1;
+        const int produceTables = 1;
+        const int typout = 0;
+        interface.crmc_init(sqrts, seed, model, produceTables, typout,
+                            paramFile.c_str(), "", 0);
+      }
+      catch (const exception& e) {
+        cerr << e.what() << endl;
+        exit(1);
+      }
+      exit(0);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+      ;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+
+}
+
+
+int
+main(int argc, char** argv)
+{
+  vector<int> models;
+  int nJobs = 0;
+  double sqrts = 0;
+  string paramFile;
+
+  try {
+    ostringstream vers;
+    vers << CRMC_VERSION_MAJOR << "." << CRMC_VERSION_MINOR << "." << CRMC_VERSION_PATCH;
+    TCLAP::CmdLine cmd("Computes the missing model tables of crmc", ' ', vers.str());
+
+    TCLAP::MultiArg<int> model(
+        "m", "model", "model to make the tables for, as in crmc (can be repeated)", true, "int");
+    cmd.add(model);
+    TCLAP::ValueArg<int> jobs(
+        "j", "jobs", "number of worker processes per table (0: all cores)", false, 0, "int");
+    cmd.add(jobs);
+    TCLAP::ValueArg<double> sqrtS(
+        "S", "sqrts", "sqrt(s/GeV**2) given to the model initialization", false, 13000, "double");
+    cmd.add(sqrtS);
+    TCLAP::ValueArg<string> config(
+        "c", "config", "config file, as for crmc", false, "crmc.param", "string");
+    cmd.add(config);
+
+    cmd.parse(argc, argv);
+
+    models = model.getValue();
+    nJobs = jobs.getValue();
+    sqrts = sqrtS.getValue();
+    paramFile = config.getValue() + ' '; // Fortran looks for the end with index
+    if (nJobs < 0) {
+      cerr << " Number of jobs must not be negative" << endl;
+      exit(1);
+    }
+  }
+  catch (TCLAP::ArgException& e) {
+    cerr << "error: " << e.error() << " for arg " << e.argId() << endl;
+    exit(1);
+  }
+
+  if (nJobs == 0)
+    nJobs = max(1u, thread::hardware_concurrency());
+  setenv("CRMC_TABLE_JOBS", to_string(nJobs).c_str(), 1);
+
+  bool ok = true;
+  for (const auto m : models)
+    if (!MakeTables(m, sqrts, paramFile)) {
+      cerr << " Tables of model " << m << " failed" << endl;
+      ok = false;
+    }
+  if (!ok)
+    exit(1);
+
+  cout << " ==[crmc-mktables]==> tables of " << models.size() << " model"
+       << (models.size() > 1 ? "s" : "") << " complete (" << nJobs << " jobs)" << endl;
+  return 0;
+}
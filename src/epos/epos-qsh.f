@@ -2170,9 +2170,21 @@ c structure functions calculation
       inquire(file=fnie(1:nfnie),exist=lcalc)
       if(lcalc)then
        if(inicnt.eq.1)then
+c binary copy of the table, see src/tabcache/TabCache.h
+        call TabCacheBegin(fnie,nfnie,'iniev',5)
+        call TabCacheArray(loc(qcdlam0),sizeof(qcdlam0))
+        call TabCacheArray(loc(q2min0),sizeof(q2min0))
+        call TabCacheArray(loc(q2ini0),sizeof(q2ini0))
+        call TabCacheArray(loc(naflav0),sizeof(naflav0))
+        call TabCacheArray(loc(epmax0),sizeof(epmax0))
+        call TabCacheArray(loc(evk0),sizeof(evk0))
+        call TabCacheArray(loc(evk),sizeof(evk))
+        call TabCacheLoad(icache)
+        if(icache.eq.0)then
         write(ifmt,'(3a)')'read from ',fnie(1:nfnie),' ...'
         open(1,file=fnie(1:nfnie),status='old')
         read (1,*)qcdlam0,q2min0,q2ini0,naflav0,epmax0
+        endif
         if(qcdlam0.ne.qcdlam)write(ifmt,'(a)')'iniev: wrong qcdlam'
         if(q2min0 .ne.q2min )write(ifmt,'(a)')'iniev: wrong q2min'
         if(q2ini0 .ne.q2ini )write(ifmt,'(a)')'iniev: wrong q2ini'
@@ -2183,8 +2195,11 @@ c structure functions calculation
            write(6,'(//a//)')'   iniev has to be reinitialized!!!'
            stop
         endif
+        if(icache.eq.0)then
         read (1,*)evk0,evk
         close(1)
+        call TabCacheSave()
+        endif
        endif
        goto 101
 
@@ -2198,7 +2213,12 @@ c structure functions calculation
 
       write(ifmt,'(a)')'iniev does not exist -> calculate tables  ...'
       xmax=1.d0-2.d0*q2ini/epmax
+c the x bins (l) are independent, see src/tabcache/TabFork.h
+      call TabForkArray(loc(evk0),sizeof(evk0))
+      call TabForkArray(loc(evk),sizeof(evk))
+      call TabForkBegin(iwork,nwork)
       do l=1,27
+      if(mod(l-1,nwork).eq.iwork)then
         if(l.le.12)then
           xx=.1d0*exp(l-13.d0)
         elseif(l.le.21)then
@@ -2225,7 +2245,9 @@ c structure functions calculation
         endif
       enddo
       enddo
+      endif
       enddo
+      call TabForkEnd()
 
       eps=0.
       n=1
@@ -2234,7 +2256,11 @@ c structure functions calculation
       write(ifmt,2)n,eps
 2     format(5x,i3,'-th order contribution ',e12.6)
 
+c evk of the previous order is only read
+      call TabForkArray(loc(evs),sizeof(evs))
+      call TabForkBegin(iwork,nwork)
       do l=1,26
+      if(mod(l-1,nwork).eq.iwork)then
         write(ifmt,*)'l',l
         if(l.le.12)then
           xx=.1d0*exp(l-13.d0)
@@ -2265,7 +2291,9 @@ c structure functions calculation
         enddo
       enddo
       enddo
+      endif
       enddo
+      call TabForkEnd()
 
       jec=0
       do i=2,21
@@ -2286,10 +2314,11 @@ c structure functions calculation
       if(jec.ne.0)goto 1
 
       write(ifmt,'(a)')'write to iniev ...'
-      open(1,file=fnie(1:nfnie),status='unknown')
+      open(1,file=fnie(1:nfnie)//'.tmp',status='unknown')
       write (1,*)qcdlam,q2min,q2ini,naflav,epmax
       write (1,*)evk0,evk
       close(1)
+      call TabCommit(fnie,nfnie)
 
 101   continue
       return
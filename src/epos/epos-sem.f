@@ -6419,9 +6419,25 @@ ccc      call MakeCSTable
       inquire(file=fnii(1:nfnii),exist=lcalc)
       if(lcalc)then
        if(inicnt.eq.1)then
+c binary copy of the table, see src/tabcache/TabCache.h
+        call TabCacheBegin(fnii,nfnii,'initl',5)
+        call TabCacheArray(loc(qcdlam0),sizeof(qcdlam0))
+        call TabCacheArray(loc(q2min0),sizeof(q2min0))
+        call TabCacheArray(loc(q2ini0),sizeof(q2ini0))
+        call TabCacheArray(loc(naflav0),sizeof(naflav0))
+        call TabCacheArray(loc(epmax0),sizeof(epmax0))
+        call TabCacheArray(loc(pt2cut0),sizeof(pt2cut0))
+        call TabCacheArray(loc(csbor),sizeof(csbor))
+        call TabCacheArray(loc(csord),sizeof(csord))
+        call TabCacheArray(loc(cstot),sizeof(cstot))
+        call TabCacheArray(loc(cstotzero),sizeof(cstotzero))
+        call TabCacheArray(loc(csborzer),sizeof(csborzer))
+        call TabCacheLoad(icache)
+        if(icache.eq.0)then
         write(ifmt,'(3a)')'read from ',fnii(1:nfnii),' ...'
         open(1,file=fnii(1:nfnii),status='old')
         read (1,*)qcdlam0,q2min0,q2ini0,naflav0,epmax0,pt2cut0
+        endif
         if(qcdlam0.ne.qcdlam)write(ifmt,'(a)')'initl: wrong qcdlam'
         if(q2min0 .ne.q2min )write(ifmt,'(a)')'initl: wrong q2min'
         if(q2ini0 .ne.q2ini )write(ifmt,'(a)')'initl: wrong q2ini'
@@ -6434,8 +6450,11 @@ ccc      call MakeCSTable
           write(ifmt,'(//a//)')'   initl has to be reinitialized!!!'
           stop
         endif
+        if(icache.eq.0)then
         read (1,*)csbor,csord,cstot,cstotzero,csborzer
         close(1)
+        call TabCacheSave()
+        endif
        endif
 
        goto 1
@@ -6698,10 +6717,11 @@ c (q2min), interpolated in the psjti0 procedure
       enddo
 
       write(ifmt,'(a)')'write to initl ...'
-      open(1,file=fnii(1:nfnii),status='unknown')
+      open(1,file=fnii(1:nfnii)//'.tmp',status='unknown')
       write (1,*)qcdlam,q2min,q2ini,naflav,epmax,pt2cut
       write (1,*)csbor,csord,cstot,cstotzero,csborzer,cschar
       close(1)
+      call TabCommit(fnii,nfnii)
 
 1     continue
 
@@ -6809,10 +6829,11 @@ c (q2min), interpolated in the psjti0 procedure
       write(ifmt,'(a)')'write to inidi ...'
 
       write(ifmt,'(a)')'write to inidi ...'
-      open(1,file=fnid(1:nfnid),status='unknown')
+      open(1,file=fnid(1:nfnid)//'.tmp',status='unknown')
       write (1,*)qcdlam,q2min,q2ini,naflav,epmax,edmax
       write (1,*)csdsi,csds,csdt,csdr
       close(1)
+      call TabCommit(fnid,nfnid)
 3     continue
 
 c---------------------------------------
@@ -6826,12 +6847,82 @@ c---------------------------------------
       inquire(file=fnrj,exist=lcalc)
       if(lcalc)then
        if(inicnt.eq.1)then
+c binary copy of the table, see src/tabcache/TabCache.h
+        call TabCacheBegin(fnrj,nfnrj,'inirj',5)
+        call TabCacheKey(loc(iclpro1),sizeof(iclpro1))
+        call TabCacheKey(loc(iclpro2),sizeof(iclpro2))
+        call TabCacheKey(loc(icltar1),sizeof(icltar1))
+        call TabCacheKey(loc(icltar2),sizeof(icltar2))
+        call TabCacheKey(loc(iclegy1),sizeof(iclegy1))
+        call TabCacheKey(loc(iclegy2),sizeof(iclegy2))
+        call TabCacheArray(loc(alpqua0),sizeof(alpqua0))
+        call TabCacheArray(loc(alplea0),sizeof(alplea0))
+        call TabCacheArray(loc(alppom0),sizeof(alppom0))
+        call TabCacheArray(loc(slopom0),sizeof(slopom0))
+        call TabCacheArray(loc(gamhad0),sizeof(gamhad0))
+        call TabCacheArray(loc(r2had0),sizeof(r2had0))
+        call TabCacheArray(loc(chad0),sizeof(chad0))
+        call TabCacheArray(loc(qcdlam0),sizeof(qcdlam0))
+        call TabCacheArray(loc(q2min0),sizeof(q2min0))
+        call TabCacheArray(loc(q2ini0),sizeof(q2ini0))
+        call TabCacheArray(loc(betpom0),sizeof(betpom0))
+        call TabCacheArray(loc(glusea0),sizeof(glusea0))
+        call TabCacheArray(loc(naflav0),sizeof(naflav0))
+        call TabCacheArray(loc(factk0),sizeof(factk0))
+        call TabCacheArray(loc(pt2cut0),sizeof(pt2cut0))
+        call TabCacheArray(loc(gamtil0),sizeof(gamtil0))
+        call TabCacheArray(loc(fhgg),sizeof(fhgg))
+        call TabCacheArray(loc(fhqg),sizeof(fhqg))
+        call TabCacheArray(loc(fhgq),sizeof(fhgq))
+        call TabCacheArray(loc(fhqq),sizeof(fhqq))
+        call TabCacheArray(loc(fhgg0),sizeof(fhgg0))
+        call TabCacheArray(loc(fhgg1),sizeof(fhgg1))
+        call TabCacheArray(loc(fhqg1),sizeof(fhqg1))
+        call TabCacheArray(loc(fhgg01),sizeof(fhgg01))
+        call TabCacheArray(loc(fhgg02),sizeof(fhgg02))
+        call TabCacheArray(loc(fhgg11),sizeof(fhgg11))
+        call TabCacheArray(loc(fhgg12),sizeof(fhgg12))
+        call TabCacheArray(loc(fhqg11),sizeof(fhqg11))
+        call TabCacheArray(loc(fhqg12),sizeof(fhqg12))
+        call TabCacheArray(loc(ftoint),sizeof(ftoint))
+        call TabCacheArray(loc(vfro),sizeof(vfro))
+        call TabCacheArray(loc(vnorm),sizeof(vnorm))
+        call TabCacheArray(loc(coefxu1),sizeof(coefxu1))
+        call TabCacheArray(loc(coefxu2),sizeof(coefxu2))
+        call TabCacheArray(loc(coefxc2),sizeof(coefxc2))
+        call TabCacheArray(loc(bkbin0),sizeof(bkbin0))
+        call TabCacheArray(loc(iclpro10),sizeof(iclpro10))
+        call TabCacheArray(loc(iclpro20),sizeof(iclpro20))
+        call TabCacheArray(loc(icltar10),sizeof(icltar10))
+        call TabCacheArray(loc(icltar20),sizeof(icltar20))
+        call TabCacheArray(loc(iclegy10),sizeof(iclegy10))
+        call TabCacheArray(loc(iclegy20),sizeof(iclegy20))
+        call TabCacheArray(loc(egylow0),sizeof(egylow0))
+        call TabCacheArray(loc(egymax0),sizeof(egymax0))
+        call TabCacheArray(loc(iomega0),sizeof(iomega0))
+        call TabCacheArray(loc(egyscr0),sizeof(egyscr0))
+        call TabCacheArray(loc(epscrw0),sizeof(epscrw0))
+        call TabCacheArray(loc(epscrp0),sizeof(epscrp0))
+        if(isetcs.gt.1)then
+        call TabCacheArray(loc(xkappafit),sizeof(xkappafit))
+        call TabCacheArray(loc(alpDs),sizeof(alpDs))
+        call TabCacheArray(loc(alpDps),sizeof(alpDps))
+        call TabCacheArray(loc(alpDpps),sizeof(alpDpps))
+        call TabCacheArray(loc(betDs),sizeof(betDs))
+        call TabCacheArray(loc(betDps),sizeof(betDps))
+        call TabCacheArray(loc(betDpps),sizeof(betDpps))
+        call TabCacheArray(loc(gamDs),sizeof(gamDs))
+        call TabCacheArray(loc(delDs),sizeof(delDs))
+        endif
+        call TabCacheLoad(icache)
+        if(icache.eq.0)then
         write(ifmt,'(3a)')'read from ',fnrj(1:nfnrj),' ...'
         open(1,file=fnrj(1:nfnrj),status='old')
         read (1,*)alpqua0,alplea0,alppom0,slopom0,
      *  gamhad0,r2had0,chad0,
      *  qcdlam0,q2min0,q2ini0,betpom0,glusea0,naflav0,
      *  factk0,pt2cut0,gamtil0
+        endif
         if(alpqua0.ne.alpqua)write(ifmt,'(a,2f8.4)')
      *  'inirj: wrong alpqua',alpqua0,alpqua
         if(alppom0.ne.alppom)write(ifmt,'(a,2f8.4)')
@@ -6883,11 +6974,13 @@ c---------------------------------------
            stop
         endif
 
+        if(icache.eq.0)then
         read(1,*)fhgg,fhqg,fhgq,fhqq,fhgg0,fhgg1,fhqg1
      *  ,fhgg01,fhgg02,fhgg11,fhgg12,fhqg11,fhqg12
      *  ,ftoint,vfro,vnorm,coefxu1,coefxu2,coefxc2
         read(1,*)bkbin0,iclpro10,iclpro20,icltar10,icltar20,iclegy10
      *   ,iclegy20,egylow0,egymax0,iomega0,egyscr0,epscrw0,epscrp0
+        endif
         if(isetcs.gt.1)then
         textini='                                      '
         if(iclpro10.ne.iclpro1)write(textini,'(a,2i8)')
@@ -6923,7 +7016,8 @@ c     *  'inirj: wrong epscrp   ',epscrp0,epscrp
         do iiitar=icltar1,icltar2
         do iiiegy=iclegy1,iclegy2
         do iiib=1,nbkbin
-          read(1,*)xkappafit(iiiegy,iiipro,iiitar,iiib)
+          if(icache.eq.0)
+     *    read(1,*)xkappafit(iiiegy,iiipro,iiitar,iiib)
         enddo
         xkappafit(iiiegy,iiipro,iiitar,nbkbin)=1.
         do iiib=2,nbkbin-1
@@ -6934,7 +7028,8 @@ c     *  'inirj: wrong epscrp   ',epscrp0,epscrp
           endif
         enddo
         do iiidf=idxD0,idxD
-         read(1,*)alpDs(iiidf,iiiegy,iiipro,iiitar),
+         if(icache.eq.0)
+     *   read(1,*)alpDs(iiidf,iiiegy,iiipro,iiitar),
      *   alpDps(iiidf,iiiegy,iiipro,iiitar),
      *   alpDpps(iiidf,iiiegy,iiipro,iiitar),
      *   betDs(iiidf,iiiegy,iiipro,iiitar),
@@ -6948,7 +7043,10 @@ c     *  'inirj: wrong epscrp   ',epscrp0,epscrp
         enddo
       endif
 
+        if(icache.eq.0)then
         close(1)
+        call TabCacheSave()
+        endif
 
       endif
 
@@ -7147,7 +7245,7 @@ c     *  'inirj: wrong epscrp   ',epscrp0,epscrp
       endif
 
       write(ifmt,'(a)')'  write to inirj ...'
-      open(1,file=fnrj,status='unknown')
+      open(1,file=fnrj(1:nfnrj)//'.tmp',status='unknown')
       write (1,*)alpqua,alplea,alppom,slopom,gamhad,r2had,chad,
      *qcdlam,q2min,q2ini,betpom,glusea,naflav,factk,pt2cut,gamtil
       write (1,*)fhgg,fhqg,fhgq,fhqq,fhgg0,fhgg1,fhqg1
@@ -7176,6 +7274,7 @@ c     *  'inirj: wrong epscrp   ',epscrp0,epscrp
       enddo
 
       close(1)
+      call TabCommit(fnrj,nfnrj)
 
       engy=engysave
       maproj=maprojsave
@@ -7198,12 +7297,57 @@ c---------------------------------------
       inquire(file=fncs,exist=lcalc)
       if(lcalc)then
        if(inicnt.eq.1)then
+c binary copy of the table, see src/tabcache/TabCache.h
+        call TabCacheBegin(fncs,nfncs,'inics',5)
+        call TabCacheKey(loc(isetcs),sizeof(isetcs))
+        call TabCacheKey(loc(ionudi),sizeof(ionudi))
+        call TabCacheArray(loc(alpqua0),sizeof(alpqua0))
+        call TabCacheArray(loc(alplea0),sizeof(alplea0))
+        call TabCacheArray(loc(alppom0),sizeof(alppom0))
+        call TabCacheArray(loc(slopom0),sizeof(slopom0))
+        call TabCacheArray(loc(gamhad0),sizeof(gamhad0))
+        call TabCacheArray(loc(r2had0),sizeof(r2had0))
+        call TabCacheArray(loc(chad0),sizeof(chad0))
+        call TabCacheArray(loc(qcdlam0),sizeof(qcdlam0))
+        call TabCacheArray(loc(q2min0),sizeof(q2min0))
+        call TabCacheArray(loc(q2ini0),sizeof(q2ini0))
+        call TabCacheArray(loc(betpom0),sizeof(betpom0))
+        call TabCacheArray(loc(glusea0),sizeof(glusea0))
+        call TabCacheArray(loc(naflav0),sizeof(naflav0))
+        call TabCacheArray(loc(factk0),sizeof(factk0))
+        call TabCacheArray(loc(pt2cut0),sizeof(pt2cut0))
+        call TabCacheArray(loc(isetcs0),sizeof(isetcs0))
+        call TabCacheArray(loc(iclpro10),sizeof(iclpro10))
+        call TabCacheArray(loc(iclpro20),sizeof(iclpro20))
+        call TabCacheArray(loc(icltar10),sizeof(icltar10))
+        call TabCacheArray(loc(icltar20),sizeof(icltar20))
+        call TabCacheArray(loc(iclegy10),sizeof(iclegy10))
+        call TabCacheArray(loc(iclegy20),sizeof(iclegy20))
+        call TabCacheArray(loc(egylow0),sizeof(egylow0))
+        call TabCacheArray(loc(egymax0),sizeof(egymax0))
+        call TabCacheArray(loc(iomega0),sizeof(iomega0))
+        call TabCacheArray(loc(egyscr0),sizeof(egyscr0))
+        call TabCacheArray(loc(epscrw0),sizeof(epscrw0))
+        call TabCacheArray(loc(epscrp0),sizeof(epscrp0))
+        call TabCacheArray(loc(asect),sizeof(asect))
+        call TabCacheArray(loc(asectn),sizeof(asectn))
+        call TabCacheArray(loc(asect11),sizeof(asect11))
+        call TabCacheArray(loc(asect13),sizeof(asect13))
+        call TabCacheArray(loc(asect21),sizeof(asect21))
+        call TabCacheArray(loc(asect23),sizeof(asect23))
+        call TabCacheArray(loc(asect31),sizeof(asect31))
+        call TabCacheArray(loc(asect33),sizeof(asect33))
+        call TabCacheArray(loc(asect41),sizeof(asect41))
+        call TabCacheArray(loc(asect43),sizeof(asect43))
+        call TabCacheLoad(icache)
+        if(icache.eq.0)then
         write(ifmt,'(3a)')'read from ',fncs(1:nfncs),' ...'
         open(1,file=fncs(1:nfncs),status='old')
         read (1,*)alpqua0,alplea0,alppom0,slopom0,
      *  gamhad0,r2had0,chad0,
      *  qcdlam0,q2min0,q2ini0,betpom0,glusea0,naflav0,
      *  factk0,pt2cut0
+        endif
         if(alpqua0.ne.alpqua)write(ifmt,'(a,2f8.4)')
      *  'inics: wrong alpqua',alpqua0,alpqua
         if(alppom0.ne.alppom)write(ifmt,'(a,2f8.4)')
@@ -7253,7 +7397,8 @@ c---------------------------------------
            stop
         endif
 
-        read(1,*)isetcs0,iclpro10,iclpro20,icltar10,icltar20,iclegy10
+        if(icache.eq.0)
+     *  read(1,*)isetcs0,iclpro10,iclpro20,icltar10,icltar20,iclegy10
      *   ,iclegy20,egylow0,egymax0,iomega0,egyscr0,epscrw0,epscrp0
 
         if(iclpro10.ne.iclpro1)write(ifmt,'(a,2i2)')
@@ -7291,7 +7436,9 @@ c     *   .or.egyscr0.ne.egyscr.or.epscrw0.ne.epscrw.or.epscrp0.ne.epscrp
            write(ifmt,'(//a//)')'   inics has to be reinitialized!!!!'
            stop
         endif
-        if(isetcs.eq.2)then
+        if(icache.ne.0)then
+          continue
+        elseif(isetcs.eq.2)then
           if(ionudi.eq.1)then
             read (1,*)asect,asect13,asect21,asect23,asectn
      *               ,asect33,asect41,asect43
@@ -7311,7 +7458,10 @@ c     *   .or.egyscr0.ne.egyscr.or.epscrw0.ne.epscrw.or.epscrp0.ne.epscrp
            write(ifmt,'(//a//)')' Wrong isetcs in psaini !!!!'
         endif
 
+        if(icache.eq.0)then
         close(1)
+        call TabCacheSave()
+        endif
 
       endif
 
@@ -7773,7 +7923,7 @@ c      fctrmx=fctrmxsave
       inicnt=1
 
       write(ifmt,'(a)')'write to inics ...'
-      open(1,file=fncs,status='unknown')
+      open(1,file=fncs(1:nfncs)//'.tmp',status='unknown')
       write (1,*)alpqua,alplea,alppom,slopom,gamhad,r2had,chad,
      *qcdlam,q2min,q2ini,betpom,glusea,naflav,factk,pt2cut
       write(1,*)isetcs,iclpro1,iclpro2,icltar1,icltar2,iclegy1,iclegy2
@@ -7782,6 +7932,7 @@ c      fctrmx=fctrmxsave
      *          ,asect31,asect33,asect41,asect43
 
       close(1)
+      call TabCommit(fncs,nfncs)
 
 
       goto 6
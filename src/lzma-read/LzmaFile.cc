@@ -5,12 +5,22 @@
 #include "Types.h"
 #include "7zFile.h"
 
-//#include <sstream>
-//#include <string>
-#include <cmath>
-#include <iostream>
-#include <queue>
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef CRMC_WITH_ZSTD
+#include <zstd.h>
+#endif
 using namespace std;
 
 const char *kCantReadMessage = "Can not read input file";
@@ -24,365 +34,345 @@ static ISzAlloc g_Alloc = { SzAlloc, SzFree };
 
 LzmaFile::LzmaFile()
 {
-  // fStorage.reserve(10000);
-  fStartNumber = false;
-
-  fReadSign = true;
-  fReadMantisseR = true;
-  fReadMantisseF = false;
-  fReadExponentSign = false;
-  fReadExponent = false;
-      
-  fNegative = false;
-  fExponentNegative = false;
-      
-  fMantisseR = 0;
-  fMantisseF = 0;
-  fMantisseFcount = 0;
-  fExponent = 0;
+  inPos = 0;
+  inSize = 0;
+  fDecodeResult = SZ_OK;
+  fBlock = 0;
+  fTextPos = 0;
+  fEndOfData = true;
+  thereIsSize = false;
+  fZstd = false;
+  fZData = 0;
+  fZSize = 0;
+}
+
+
+LzmaFile::~LzmaFile()
+{
+  if (fDecoder.joinable())
+    Close();
 }
 
 
 SRes 
 LzmaFile::Open(const string& fileName) 
 {
-  //fStrNumber.str("");
-  //fStrNumber.clear();
-  
-  FileSeqInStream_CreateVTable(&inStream);
-  File_Construct(&inStream.file);
-
-  if (InFile_Open(&inStream.file, fileName.c_str()) != 0) {
-    cout << "Cannot open input file: " << fileName << endl;
-    cout << "First use: \n\t \'lzma --best " << fileName.substr(0, fileName.rfind(".lzma")) << "\'"
-	 << " to create it. "
-	 << endl;
-    exit(1);
-  }
+  if (fDecoder.joinable())
+    Close();
+
+  // made before any early return, Close() and NextBlock() use them
+  fBlock = 0;
+  fEndOfData = true;
+  fFree.reset(new CRMCqueue<Block*>(N_OUT_BUF));
+  fFull.reset(new CRMCqueue<Block*>(N_OUT_BUF));
+
+  fZstd = (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".zst") == 0);
+  if (fZstd) {
+    RINOK(OpenZstd(fileName));
+  } else {
+    FileSeqInStream_CreateVTable(&inStream);
+    File_Construct(&inStream.file);
+    LzmaDec_Construct(&state);
+
+    if (InFile_Open(&inStream.file, fileName.c_str()) != 0) {
+      cout << "Cannot open input file: " << fileName << endl;
+      cout << "First use: \n\t \'lzma --best " << fileName.substr(0, fileName.rfind(".lzma")) << "\'"
+	   << " to create it. "
+	   << endl;
+      exit(1);
+    }
   
-  ISeqInStream *stream = &inStream.s;
+    ISeqInStream *stream = &inStream.s;
   
-  /* Read and parse header */
-  /* header: 5 bytes of LZMA properties and 8 bytes of uncompressed size */
-  unsigned char header[LZMA_PROPS_SIZE + 8];
-  RINOK(SeqInStream_Read(stream, header, sizeof(header)));
+    /* Read and parse header */
+    /* header: 5 bytes of LZMA properties and 8 bytes of uncompressed size */
+    unsigned char header[LZMA_PROPS_SIZE + 8];
+    RINOK(SeqInStream_Read(stream, header, sizeof(header)));
   
-  unpackSize = 0;
-  int i = 0;
-  for (i = 0; i < 8; i++)
-    unpackSize += (UInt64)header[LZMA_PROPS_SIZE + i] << (i * 8);
+    unpackSize = 0;
+    for (int i = 0; i < 8; i++)
+      unpackSize += (UInt64)header[LZMA_PROPS_SIZE + i] << (i * 8);
+    thereIsSize = (unpackSize != (UInt64)(Int64)-1);
   
-  LzmaDec_Construct(&state);
-  RINOK(LzmaDec_Allocate(&state, header, LZMA_PROPS_SIZE, &g_Alloc));
-  LzmaDec_Init(&state);
+    RINOK(LzmaDec_Allocate(&state, header, LZMA_PROPS_SIZE, &g_Alloc));
+    LzmaDec_Init(&state);
+  }
   
   inPos = 0;
   inSize = 0;
-  outPos = 0;
+  fBlock = 0;
+  fTextPos = 0;
+  fEndOfData = false;
+  fToken.clear();
+
+  fDecodeResult = SZ_OK;
+  for (int i = 0; i < N_OUT_BUF; i++)
+    fFree->push(&fBlocks[i]);
+  fDecoder = std::thread(&LzmaFile::Decode, this);
   return SZ_OK;  
 }
 
+
 SRes
 LzmaFile::ReadNextNumber(double& data)
 {
-  if (fStorage.empty()) {
-    const int ret = DecodeBuffer();
-    if (ret != SZ_OK) {
-      cout << "Error in ReadNextNumber  ret=" << ret << endl;
+  return FillArray(&data, 1);
+}
+
+
+SRes
+LzmaFile::FillArray(double* data, const int length)
+{
+  // parsed straight from the decoded text into the Fortran array
+  for (int i=0; i<length; ++i) {
+    const char* begin = 0;
+    const char* end = 0;
+    if (!NextToken(begin, end)) {
+      cout << "Error in FillArray i=" << i << " length=" << length << endl;
       return SZ_ERROR_DATA;
     }
+    data[i] = ParseNumber(begin, end);
   }
   
-  data = fStorage.front();
-  fStorage.pop();
   return SZ_OK;
 }
 
 
+static inline bool
+IsBlank(const char c)
+{
+  return c==' ' || c=='\n' || c=='\r' || c=='\t';
+}
 
-SRes
-LzmaFile::FillArray(double* data, const int length)
+
+bool
+LzmaFile::NextToken(const char*& begin, const char*& end)
 {
-  for (int i=0; i<length; ++i) {
-    
-    if (fStorage.empty()) {
-      const int ret = DecodeBuffer();
-      if (ret != SZ_OK) {
-	cout << "Error in FillArray i=" << i << " ret=" << ret << endl;
-	return SZ_ERROR_DATA;
-      }
+  fToken.clear();
+  for (;;) {
+    if (!fBlock || fTextPos == fBlock->fSize) {
+      if (!NextBlock())
+	break;
+      continue;
     }
-    
-    data[i] = fStorage.front();
-    fStorage.pop();
-    
+    const char* text = (const char*)fBlock->fText;
+    const size_t size = fBlock->fSize;
+    if (fToken.empty())
+      while (fTextPos < size && IsBlank(text[fTextPos]))
+	++fTextPos;
+    size_t last = fTextPos;
+    while (last < size && !IsBlank(text[last]))
+      ++last;
+
+    if (last < size && fToken.empty()) { // usual case, parsed in place
+      begin = text + fTextPos;
+      end = text + last;
+      fTextPos = last;
+      return true;
+    }
+    fToken.append(text + fTextPos, last - fTextPos);
+    fTextPos = last;
+    if (last < size)
+      break;
   }
-  
-  return SZ_OK;
-  
+
+  // a number continued in the next block or the last one of the file
+  if (fToken.empty())
+    return false;
+  begin = fToken.data();
+  end = fToken.data() + fToken.size();
+  return true;
+}
+
+
+bool
+LzmaFile::NextBlock()
+{
+  if (fBlock)
+    fFree->push(fBlock);
+  fBlock = 0;
+  fTextPos = 0;
+  if (fEndOfData)
+    return false;
+  if (!fFull->pop(fBlock)) {
+    fEndOfData = true;
+    if (fDecodeResult != SZ_OK)
+      cout << "LzmaFile: error in DecodeBuffer ret=" << fDecodeResult << endl;
+    return false;
+  }
+  return true;
 }
 
 
 /*
-double 
-LzmaFile::strToDouble(const char& p) {
+ * Exact powers of ten: a mantissa below 2^53 times or divided by one of
+ * them is correctly rounded (Clinger's fast path).  Everything else, very
+ * long mantissas or large exponents, goes through strtod.
+ */
+static const double kPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const UInt64 kMaxMantissa = (UInt64(1) << 53);
+
+
+static void
+WrongCharacter(const char* begin, const char* end)
+{
+  cout << "LzmaFile: found \'" << string(begin, end) << "\' instead of a number. " << endl;
+  exit(10);
+}
 
-  // init
-  fR = 0;  
-  fNegative = false;
-  
-  if (*p == '-') {
-    neg = true;
+
+double
+LzmaFile::ParseNumber(const char* begin, const char* end)
+{
+  const char* p = begin;
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = (*p == '-');
     ++p;
   }
-  while (*p >= '0' && *p <= '9') {
-    r = (r*10.0) + (*p - '0');
-    ++p;
+
+  UInt64 mantissa = 0;
+  int exponent = 0;
+  int nDigits = 0;
+  bool exact = true;
+  for (; p < end && unsigned(*p - '0') < 10; ++p, ++nDigits) {
+    if (mantissa < kMaxMantissa / 10)
+      mantissa = mantissa*10 + (*p - '0');
+    else {
+      exact = false;
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && unsigned(*p - '0') < 10; ++p, ++nDigits) {
+      if (mantissa < kMaxMantissa / 10) {
+	mantissa = mantissa*10 + (*p - '0');
+	--exponent;
+      } else
+	exact = false;
+    }
   }
-  if (*p == '.') {
-    double f = 0.0;
-    int n = 0;
+  if (nDigits == 0)
+    WrongCharacter(begin, end);
+
+  // also the Fortran D exponent
+  if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
     ++p;
-    while (*p >= '0' && *p <= '9') {
-      f = (f*10.0) + (*p - '0');
+    bool exponentNegative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      exponentNegative = (*p == '-');
       ++p;
-      ++n;
     }
-    r += f / std::pow(10.0, n);
+    if (p == end)
+      WrongCharacter(begin, end);
+    int e = 0;
+    for (; p < end && unsigned(*p - '0') < 10; ++p)
+      if (e < 100000)
+	e = e*10 + (*p - '0');
+    exponent += (exponentNegative ? -e : e);
   }
-  if (neg) {
-    r = -r;
+  if (p != end)
+    WrongCharacter(begin, end);
+
+  double number = 0;
+  if (exact && exponent >= -22 && exponent <= 22) {
+    number = double(mantissa);
+    if (exponent < 0)
+      number /= kPow10[-exponent];
+    else
+      number *= kPow10[exponent];
+  } else {
+    string token(begin, end);
+    for (size_t i = 0; i < token.size(); ++i)
+      if (token[i] == 'd' || token[i] == 'D')
+	token[i] = 'e';
+    return strtod(token.c_str(), 0);
   }
-  return r;
+  return (negative ? -number : number);
 }
-*/
 
 
-SRes
-LzmaFile::DecodeBuffer()
+void
+LzmaFile::Decode()
 {
-  ISeqInStream *stream = &inStream.s;
-  
-  const int thereIsSize = (unpackSize != (UInt64)(Int64)-1);
-  
-    
-  if (inPos == inSize) {
-    inSize = IN_BUF_SIZE;
-    RINOK(stream->Read(stream, inBuf, &inSize));
-    inPos = 0;
+  if (fZstd) {
+    fDecodeResult = DecodeZstd();
+    fFull->close();
+    return;
   }
-  
-  SizeT inProcessed = inSize - inPos;
-  SizeT outProcessed = OUT_BUF_SIZE - outPos;
-  ELzmaFinishMode finishMode = LZMA_FINISH_ANY;
-  ELzmaStatus status;
-  
-  if (thereIsSize && outProcessed > unpackSize) {
-    outProcessed = (SizeT)unpackSize;
-    finishMode = LZMA_FINISH_END;
-  }
-  
-  SRes res = LzmaDec_DecodeToBuf(&state, outBuf, &outProcessed,
-				 inBuf + inPos, &inProcessed, finishMode, &status);
-  inPos += inProcessed;
-  unpackSize -= outProcessed;
-  
-    
-  const char* strBuf = (const char*)outBuf;
 
-  int countC = 0;
-  int countNum = 0;
-  do {
-    
-    if (countC >= int(outProcessed)) {
-      // cout << " countC=" << countC 
-      // 	   << " outProcessed=" << outProcessed
-      // 	   << endl;
+  Block* block = 0;
+  bool endOfData = false;
+  while (!endOfData && fFree->pop(block)) {
+    block->fSize = 0;
+    const SRes ret = DecodeBuffer(*block);
+    if (ret != SZ_OK) {
+      fDecodeResult = ret; // seen by the parser after fFull is closed
       break;
     }
-    
-    const char& C = strBuf[countC]; 
-    countC++;
-    
-    //cout << "\'" << C << "\'" << endl;
-    
-    if (C==' ' || C=='\n') { // END OF NUMBER
-
-      if (!fStartNumber) 
-	continue;
-      
-      //istringstream strToNum(fStrNumber.str().c_str());
-      //double number = atof(fStrNumber.str().c_str());
-      //strToNum >> number;
-      
-      const double number = (fNegative?-1:1) * (fMantisseR + fMantisseF/pow(10., fMantisseFcount)) * pow(10., (fExponentNegative?-1:1) * fExponent);
-      //cout << " number=" << number << endl;
-      
-      fStorage.push(number);      
-      countNum++;
-      
-      fStartNumber = false;
-
-      fReadSign = true;
-      fReadMantisseR = true;
-      fReadMantisseF = false;
-      fReadExponentSign = false;
-      fReadExponent = false;
-      
-      fNegative = false;
-      fExponentNegative = false;
-      
-      fMantisseR = 0;
-      fMantisseF = 0;
-      fMantisseFcount = 0;
-      fExponent = 0;
-      
-      continue;
-    }
-    
-    fStartNumber = true;
-    const int num = C - '0';
-    if (num >= 0 && num <= 9) {
-	
-      if (fReadMantisseR) {
-	fReadSign = false;
-	fMantisseR = fMantisseR*10 + num;
-      } else if (fReadMantisseF) {
-	fReadSign = false;
-	fMantisseF = fMantisseF*10 + num;
-	++fMantisseFcount;
-      } else if (fReadExponent) {
-	fReadExponentSign = false;
-	fExponent = fExponent*10 + num;
-      }
-      
-    } else {
-      
-      switch(C) {
-      case '-':
-	{
-	  if (fReadSign) {
-	    fNegative = true;
-	    fReadSign = false;
-	    fReadMantisseR = true;
-	  } else if (fReadExponentSign) {	
-	    fExponentNegative = true;
-	    fReadExponentSign = false;
-	    fReadExponent = true;
-	  } else {
-	    cout << "LzmaFile: found \'" << C << "\' at wrong position. " << endl;
-	    exit(10);
-	  }
-	}
-	break;
-      case '.': 
-	if (!fReadMantisseR) {
-	  cout << "LzmaFile: found \'" << C << "\' at wrong position. " << endl;
-	  exit(10);
-	}
-	fReadMantisseR = false;
-	fReadMantisseF = true;
-	break;
-      case 'e':
-      case 'E':
-      case 'D': 
-      case 'd':
-	if (!fReadMantisseR || !fReadMantisseF) {
-	  fReadMantisseR = false;
-	  fReadMantisseF = false;
-	  fReadExponentSign = true;
-	  fReadExponent = true;
-	}
-	break;
-      default:
-	cout << "LzmaFile: found \'" << C << "\' at wrong position. " << endl;
-	exit(10);
-	break;
-      }
-    }
-	
-  } while(true);
-  
-  //strBuf.str("");
-  //strBuf.clear();
-  
-
-  /*    
-  if (!strNumber.str().empty()) {
-    cout << "NACHZUEGLER" << endl;
-    istringstream strToNum(strNumber.str());
-    double number;
-    strToNum >> number;
-    fStorage.push(number);
-  }
-  */
-    
-  
-
-    
-  if (res != SZ_OK || (thereIsSize && unpackSize == 0)) 
-    return res;
-    
-  if (inProcessed == 0 && outProcessed == 0) {
-    if (thereIsSize || status != LZMA_STATUS_FINISHED_WITH_MARK)
-      return SZ_ERROR_DATA;
-    return res;
+    endOfData = (block->fSize < OUT_BUF_SIZE);
+    if (block->fSize > 0 && !fFull->push(block))
+      break;
   }
-
-  return SZ_OK;
+  fFull->close();
 }
 
 
-
-
 SRes
-LzmaFile::DecodeAll()
+LzmaFile::DecodeBuffer(Block& block)
 {
   ISeqInStream *stream = &inStream.s;
 
-  int thereIsSize = (unpackSize != (UInt64)(Int64)-1);
-  
-  for (;;) {
-
+  // a block is filled unless the data ends
+  while (block.fSize < OUT_BUF_SIZE) {
+    
     if (inPos == inSize) {
       inSize = IN_BUF_SIZE;
       RINOK(stream->Read(stream, inBuf, &inSize));
       inPos = 0;
     }
-    
+  
     SizeT inProcessed = inSize - inPos;
-    SizeT outProcessed = OUT_BUF_SIZE - outPos;
+    SizeT outProcessed = OUT_BUF_SIZE - block.fSize;
     ELzmaFinishMode finishMode = LZMA_FINISH_ANY;
     ELzmaStatus status;
-    
+  
     if (thereIsSize && outProcessed > unpackSize) {
       outProcessed = (SizeT)unpackSize;
       finishMode = LZMA_FINISH_END;
     }
-    
-    SRes res = LzmaDec_DecodeToBuf(&state, outBuf, &outProcessed,
+  
+    SRes res = LzmaDec_DecodeToBuf(&state, block.fText + block.fSize, &outProcessed,
 				   inBuf + inPos, &inProcessed, finishMode, &status);
     inPos += inProcessed;
     unpackSize -= outProcessed;
-    
-    
-    unsigned int k=0;
-    for (k=0; k<outProcessed; ++k) {
-      printf("%c", outBuf[k]);
-    }
-  
-    if (res != SZ_OK || (thereIsSize && unpackSize == 0))
+    block.fSize += outProcessed;
+
+    if (res != SZ_OK)
       return res;
-    
+
+    if (thereIsSize && unpackSize == 0)
+      break;
     if (inProcessed == 0 && outProcessed == 0) {
       if (thereIsSize || status != LZMA_STATUS_FINISHED_WITH_MARK)
 	return SZ_ERROR_DATA;
-      return res;
+      break;
     }
+  }
 
-  } // for loop
-  
-  return 0;
+  return SZ_OK;
+}
+
+
+SRes
+LzmaFile::DecodeAll()
+{
+  while (NextBlock())
+    fwrite(fBlock->fText, 1, fBlock->fSize, stdout);
+  return fDecodeResult;
 }
 
 
@@ -390,7 +380,229 @@ LzmaFile::DecodeAll()
 SRes
 LzmaFile::Close()
 {
+  // the tables are often not read to their end
+  if (!fFree)
+    return SZ_OK; // never opened
+  fFree->close();
+  fFull->close();
+  if (fDecoder.joinable())
+    fDecoder.join();
+  fBlock = 0;
+  fEndOfData = true;
+
+  if (fZstd) {
+    CloseZstd();
+    return SZ_OK;
+  }
   LzmaDec_Free(&state, &g_Alloc);
   res = File_Close(&inStream.file);
   return res;
 }
+
+
+#ifdef CRMC_WITH_ZSTD
+
+SRes
+LzmaFile::OpenZstd(const string& fileName)
+{
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    cout << "Cannot open input file: " << fileName << endl;
+    cout << "First use: \n\t \'pzstd -19 " << fileName.substr(0, fileName.rfind(".zst")) << "\'"
+	 << " to create it. "
+	 << endl;
+    exit(1);
+  }
+  fZSize = st.st_size;
+  void* data = (fZSize > 0 ? mmap(0, fZSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+  close(fd);
+  if (data == MAP_FAILED) {
+    cout << "LzmaFile: cannot map " << fileName << endl;
+    fZSize = 0;
+    return SZ_ERROR_READ;
+  }
+  fZData = (const Byte*)data;
+  madvise(data, fZSize, MADV_SEQUENTIAL);
+
+  // the frame headers give their compressed sizes, no need to decode
+  fFrames.clear();
+  for (size_t pos = 0; pos < fZSize; ) {
+    const size_t size = ZSTD_findFrameCompressedSize(fZData + pos, fZSize - pos);
+    if (ZSTD_isError(size)) {
+      cout << "LzmaFile: " << fileName << " is not a complete zstd file: "
+           << ZSTD_getErrorName(size) << endl;
+      exit(1);
+    }
+    fFrames.push_back(make_pair(pos, size));
+    pos += size;
+  }
+  return SZ_OK;
+}
+
+
+/*
+ * One frame (or a single thread): streamed into the blocks.  Several
+ * frames: each is decompressed into memory by a thread of its own, at
+ * most N_ZSTD_THREADS ahead of the one being parsed; the parser is the
+ * slower part, more threads would only use memory.
+ */
+SRes
+LzmaFile::DecodeZstd()
+{
+  const size_t nThreads = min<size_t>(min<size_t>(fFrames.size(), N_ZSTD_THREADS),
+                                      max(1u, thread::hardware_concurrency()));
+  Block* block = 0;
+
+  if (nThreads <= 1) {
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    ZSTD_inBuffer in = { fZData, fZSize, 0 };
+    SRes result = SZ_OK;
+    for (;;) {
+      if (!block) {
+        if (!fFree->pop(block))
+          break; // closed before the end of the file
+        block->fSize = 0;
+      }
+      ZSTD_outBuffer out = { block->fText + block->fSize, OUT_BUF_SIZE - block->fSize, 0 };
+      const size_t ret = ZSTD_decompressStream(stream, &out, &in);
+      if (ZSTD_isError(ret)) {
+        result = SZ_ERROR_DATA;
+        break;
+      }
+      block->fSize += out.pos;
+      // all input used and nothing left to flush
+      if (in.pos == in.size && out.pos < out.size) {
+        if (ret != 0)
+          result = SZ_ERROR_DATA; // truncated frame
+        if (block->fSize > 0 && result == SZ_OK)
+          fFull->push(block);
+        break;
+      }
+      if (block->fSize == OUT_BUF_SIZE) {
+        if (!fFull->push(block))
+          break;
+        block = 0;
+      }
+    }
+    ZSTD_freeDStream(stream);
+    return result;
+  }
+
+  deque<future<pair<SRes, string> > > pending;
+  size_t next = 0;
+  for (size_t frame = 0; frame < fFrames.size(); ++frame) {
+    while (next < fFrames.size() && pending.size() < nThreads) {
+      const size_t f = next++;
+      pending.push_back(async(launch::async, [this, f]() {
+            pair<SRes, string> result;
+            result.first = DecodeFrame(f, result.second);
+            return result;
+          }));
+    }
+    const pair<SRes, string> text = pending.front().get();
+    pending.pop_front();
+    if (text.first != SZ_OK)
+      return text.first;
+
+    for (size_t pos = 0; pos < text.second.size(); ) {
+      if (!block) {
+        if (!fFree->pop(block))
+          return SZ_OK; // closed, the frames in flight are waited for
+        block->fSize = 0;
+      }
+      const size_t n = min(text.second.size() - pos, OUT_BUF_SIZE - block->fSize);
+      memcpy(block->fText + block->fSize, text.second.data() + pos, n);
+      block->fSize += n;
+      pos += n;
+      if (block->fSize == OUT_BUF_SIZE) {
+        if (!fFull->push(block))
+          return SZ_OK;
+        block = 0;
+      }
+    }
+  }
+  if (block && block->fSize > 0)
+    fFull->push(block);
+  return SZ_OK;
+}
+
+
+SRes
+LzmaFile::DecodeFrame(const size_t frame, string& text)
+  const
+{
+  const Byte* data = fZData + fFrames[frame].first;
+  const size_t size = fFrames[frame].second;
+  const unsigned long long contentSize = ZSTD_getFrameContentSize(data, size);
+  if (contentSize == ZSTD_CONTENTSIZE_ERROR)
+    return SZ_ERROR_DATA;
+  if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN) {
+    text.resize(contentSize);
+    const size_t ret = ZSTD_decompress(&text[0], contentSize, data, size);
+    return (ZSTD_isError(ret) || ret != contentSize ? SZ_ERROR_DATA : SZ_OK);
+  }
+
+  // pzstd does not always store the size
+  ZSTD_DStream* stream = ZSTD_createDStream();
+  ZSTD_initDStream(stream);
+  ZSTD_inBuffer in = { data, size, 0 };
+  size_t ret = 1;
+  text.resize(max<size_t>(4 * size, OUT_BUF_SIZE));
+  size_t textSize = 0;
+  while (ret != 0) {
+    if (textSize == text.size())
+      text.resize(2 * text.size());
+    ZSTD_outBuffer out = { &text[textSize], text.size() - textSize, 0 };
+    ret = ZSTD_decompressStream(stream, &out, &in);
+    textSize += out.pos;
+    if (ZSTD_isError(ret) || (in.pos == in.size && out.pos == 0 && ret != 0)) {
+      ZSTD_freeDStream(stream);
+      return SZ_ERROR_DATA;
+    }
+  }
+  ZSTD_freeDStream(stream);
+  text.resize(textSize);
+  return SZ_OK;
+}
+
+#else
+
+SRes
+LzmaFile::OpenZstd(const string& fileName)
+{
+  cout << "LzmaFile: crmc was built without zstd, cannot read " << fileName << endl;
+  cout << "Use: \n\t \'unzstd " << fileName << "\'"
+       << " and the uncompressed file. "
+       << endl;
+  exit(1);
+}
+
+
+SRes
+LzmaFile::DecodeZstd()
+{
+  return SZ_ERROR_UNSUPPORTED;
+}
+
+
+SRes
+LzmaFile::DecodeFrame(const size_t, string&)
+  const
+{
+  return SZ_ERROR_UNSUPPORTED;
+}
+
+#endif
+
+
+void
+LzmaFile::CloseZstd()
+{
+  if (fZData)
+    munmap((void*)fZData, fZSize);
+  fZData = 0;
+  fZSize = 0;
+  fFrames.clear();
+}
@@ -5,8 +5,13 @@
 #include "7zFile.h"
 #include "LzmaDec.h"
 
+#include <memory>
 #include <string>
-#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <CRMCqueue.h>
 
 #include "LzmaDec.h"
 #include "Alloc.h"
@@ -16,59 +21,92 @@
 #include <sstream>
 #include <string>
 #include <iostream>
-#include <queue>
 using namespace std;
 
 
 
-#define IN_BUF_SIZE (1 << 16)
-#define OUT_BUF_SIZE (1 << 16)
+// large buffers, the decompressed tables are many MB of text
+#define IN_BUF_SIZE (1 << 20)
+#define OUT_BUF_SIZE (1 << 20)
+#define N_OUT_BUF 4
+
+// frames of a .zst file decoded at the same time
+#define N_ZSTD_THREADS 4
 
+/*
+ * Reads the blank separated numbers of an LZMA compressed text file.
+ *
+ * A decoder thread started by Open() reads and decompresses the file
+ * into a ring of N_OUT_BUF text blocks, while FillArray() parses the
+ * blocks already decoded into the destination array: loading the
+ * tables takes the longer of decoding and parsing, not their sum.
+ *
+ * Files ending with .zst are zstd compressed (if built with zstd).  The
+ * independent frames of a file written by pzstd are decompressed by up
+ * to N_ZSTD_THREADS threads and handed to the parser in order.
+ */
 struct LzmaFile {
 
+  struct Block {
+    Byte fText[OUT_BUF_SIZE];
+    size_t fSize;
+  };
+
   LzmaFile();
+  ~LzmaFile();
 
   SRes Open(const std::string& fileName);
   SRes Close();
   SRes DecodeAll();
-  SRes DecodeBuffer();
-   //SRes DecodeArray(double* data, const int length);
   SRes ReadNextNumber(double& data);
   SRes FillArray(double* data, const int length);
+
+  // decoder thread
+  void Decode();
+  SRes DecodeBuffer(Block& block);
+
+  // zstd
+  SRes OpenZstd(const std::string& fileName);
+  SRes DecodeZstd();
+  SRes DecodeFrame(const size_t frame, std::string& text) const;
+  void CloseZstd();
+
+  // next blank separated number in [begin, end), false at the end of the data
+  bool NextToken(const char*& begin, const char*& end);
+  bool NextBlock();
+  static double ParseNumber(const char* begin, const char* end);
   
   CFileSeqInStream inStream;
   int res;
   CLzmaDec state;
   
-  // std::ostringstream fStrNumber;
-
   UInt64 unpackSize;
+  bool thereIsSize; // else the data ends with a mark
   
   Byte inBuf[IN_BUF_SIZE];
-  Byte outBuf[OUT_BUF_SIZE];
-
-  std::queue<double> fStorage;
 
   size_t inPos;
   size_t inSize;
-  size_t outPos;
 
-  // string converting
-  bool fStartNumber;
-
-  bool fReadSign;
-  bool fReadMantisseR;
-  bool fReadMantisseF;
-  bool fReadExponentSign;
-  bool fReadExponent;
-  
-  bool fNegative;
-  bool fExponentNegative;
-      
-  double fMantisseR;
-  double fMantisseF;
-  int fMantisseFcount;
-  int fExponent;
+  // zstd: the mapped file and its frames [offset, offset + size)
+  bool fZstd;
+  const Byte* fZData;
+  size_t fZSize;
+  std::vector<std::pair<size_t, size_t> > fFrames;
+
+  // decoded blocks go from fFree to fFull and back
+  Block fBlocks[N_OUT_BUF];
+  std::unique_ptr<CRMCqueue<Block*> > fFree;
+  std::unique_ptr<CRMCqueue<Block*> > fFull;
+  std::thread fDecoder;
+  SRes fDecodeResult;
+
+  // block being parsed, fBlock->fText[fTextPos, fBlock->fSize) not yet parsed
+  Block* fBlock;
+  size_t fTextPos;
+  bool fEndOfData;
+  // a number continued in the next block
+  std::string fToken;
 
 };
 
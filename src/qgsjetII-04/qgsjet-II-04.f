@@ -419,12 +419,38 @@ c reading cross sections from the file
       endif
       lzmaUse=0
       if(lcalc)then
+c binary copy of the table, see src/tabcache/TabCache.h
+        icache=0
+        if(ifIIdat.eq.1)then
+         call TabCacheBegin(fnIIdat,nfnIIdat,'qgsdat-II-04',12)
+         call TabCacheArray(loc(csborn),sizeof(csborn))
+         call TabCacheArray(loc(cs0),sizeof(cs0))
+         call TabCacheArray(loc(cstot),sizeof(cstot))
+         call TabCacheArray(loc(evk),sizeof(evk))
+         call TabCacheArray(loc(qpomi),sizeof(qpomi))
+         call TabCacheArray(loc(qpomis),sizeof(qpomis))
+         call TabCacheArray(loc(qlegi),sizeof(qlegi))
+         call TabCacheArray(loc(qfanu),sizeof(qfanu))
+         call TabCacheArray(loc(qfanc),sizeof(qfanc))
+         call TabCacheArray(loc(qdfan),sizeof(qdfan))
+         call TabCacheArray(loc(qpomr),sizeof(qpomr))
+         call TabCacheArray(loc(gsect),sizeof(gsect))
+         call TabCacheArray(loc(qlegc0),sizeof(qlegc0))
+         call TabCacheArray(loc(qlegc),sizeof(qlegc))
+         call TabCacheArray(loc(qpomc),sizeof(qpomc))
+         call TabCacheArray(loc(fsud),sizeof(fsud))
+         call TabCacheArray(loc(qrt),sizeof(qrt))
+         call TabCacheArray(loc(qrev),sizeof(qrev))
+         call TabCacheLoad(icache)
+        endif
+        if(icache.eq.0)then
          if(ifIIdat.ne.1)then
             open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-II-04'
      *           ,status='old')
          else                   !used to link with nexus
             if (LEN(fnIIdat).gt.6.and.
-     *           fnIIdat(nfnIIdat-4:nfnIIdat) .eq. ".lzma") then
+     *           (fnIIdat(nfnIIdat-4:nfnIIdat) .eq. ".lzma".or.
+     *            fnIIdat(nfnIIdat-3:nfnIIdat) .eq. ".zst")) then
                lzmaUse=1
                call LzmaOpenFile(fnIIdat(1:nfnIIdat))
             else
@@ -464,6 +490,8 @@ c reading cross sections from the file
      *         qrt
           close(1)
        endif
+        if(ifIIdat.eq.1)call TabCacheSave()
+        endif
 
        if(debug.ge.0)write (moniou,*)'done'
        goto 10
@@ -1144,11 +1172,14 @@ c loop-legs
 c-------------------------------------------------
 c uncut fan-contributions
       if(debug.ge.1)write (moniou,213)
+c the (icz,icdp) cells are independent, see src/tabcache/TabFork.h
+      call TabForkArray(loc(qfanu),sizeof(qfanu))
+      call TabForkBegin(iwork,nwork)
       do icz=1,3
       do iv=1,11
        vvx=dble(iv-1)/10.d0
       do icdp=1,2
-       if(cd(icdp,icz).ne.0.d0)then
+       if(cd(icdp,icz).ne.0.d0.and.mod(icdp+2*icz-3,nwork).eq.iwork)then
         do iy=1,51
         do iz=1,11
         do iqq=1,2
@@ -1218,13 +1249,16 @@ c uncut fan-contributions
       enddo
       enddo
       enddo
+      call TabForkEnd()
 
 c-------------------------------------------------
 c cut fan contributions
       if(debug.ge.1)write (moniou,215)
+      call TabForkArray(loc(qfanc),sizeof(qfanc))
+      call TabForkBegin(iwork,nwork)
       do icz=1,3                                !hadron class
       do icdp=1,2                                 !diffractive eigenstate
-       if(cd(icdp,icz).ne.0.d0)then
+       if(cd(icdp,icz).ne.0.d0.and.mod(icdp+2*icz-3,nwork).eq.iwork)then
 c vvx,vvxp,vvxpl - screening corrections from targ. and nuclear proj. fans
         do iv=1,11
          vvx=dble(iv-1)/10.d0
@@ -1311,6 +1345,7 @@ c vvx,vvxp,vvxpl - screening corrections from targ. and nuclear proj. fans
        endif
       enddo
       enddo
+      call TabForkEnd()
 
 c-------------------------------------------------
 c zigzag fans
@@ -1944,14 +1979,20 @@ c-----------------------------------------------------------------------------
 c writing cross sections to the file
       if(debug.ge.1)write (moniou,220)
       if(ifIIdat.ne.1)then
-       open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-II-04'
+       open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-II-04.tmp'
      * ,status='unknown')
       else                                              !used to link with nexus
-       open(ifIIdat,file=fnIIdat(1:nfnIIdat),status='unknown')
+       open(ifIIdat,file=fnIIdat(1:nfnIIdat)//'.tmp',status='unknown')
       endif
       write (1,*)csborn,cs0,cstot,evk,qpomi,qpomis,qlegi,qfanu,qfanc
      *,qdfan,qpomr,gsect,qlegc0,qlegc,qpomc,fsud,qrt,qrev,fsud,qrt
       close(1)
+      if(ifIIdat.ne.1)then
+       call TabCommit(DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-II-04'
+     * ,INDEX(DATDIR,' ')+11)
+      else
+       call TabCommit(fnIIdat,nfnIIdat)
+      endif
 
 10    continue
 c-----------------------------------------------------------------------------
@@ -2004,13 +2045,19 @@ c nuclear cross sections
        enddo
        enddo
        if(ifIIncs.ne.2)then
-        open(2,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-II-04'
+        open(2,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-II-04.tmp'
      *  ,status='unknown')
        else                                                  !ctp
-        open(ifIIncs,file=fnIIncs(1:nfnIIncs),status='unknown')
+        open(ifIIncs,file=fnIIncs(1:nfnIIncs)//'.tmp',status='unknown')
        endif
        write (2,*)qgsasect
        close(2)
+       if(ifIIncs.ne.2)then
+        call TabCommit(DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-II-04'
+     *  ,INDEX(DATDIR,' ')+11)
+       else
+        call TabCommit(fnIIncs,nfnIIncs)
+       endif
       endif
 
       if(debug.ge.3)write (moniou,218)
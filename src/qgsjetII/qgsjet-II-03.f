@@ -375,7 +375,8 @@ c check normalization
         if(debug.ge.0)write (moniou,203) 'qgsdat-II-03'
        else                                                !used to link with nexus
           if (LEN(fnII03dat).gt.6.and.
-     *         fnII03dat(nfnII03dat-4:nfnII03dat) .eq. ".lzma") then
+     *         (fnII03dat(nfnII03dat-4:nfnII03dat) .eq. ".lzma".or.
+     *          fnII03dat(nfnII03dat-3:nfnII03dat) .eq. ".zst")) then
              lzmaUse=1
              call LzmaOpenFile(fnII03dat(1:nfnII03dat))
           else
@@ -402,12 +402,39 @@ c     *       ,fnIIIdat(1:nfnIIIdat)
       lzmaUse=0
       if(lcalc)then
         if(debug.ge.2)write (moniou,205)
+c binary copy of the table, see src/tabcache/TabCache.h
+        icache=0
+        if(ifIIIdat.eq.1)then
+         call TabCacheBegin(fnIIIdat,nfnIIIdat,'qgsdat-III',10)
+         call TabCacheArray(loc(csborn),sizeof(csborn))
+         call TabCacheArray(loc(cs0),sizeof(cs0))
+         call TabCacheArray(loc(cstot),sizeof(cstot))
+         call TabCacheArray(loc(evk),sizeof(evk))
+         call TabCacheArray(loc(qpomi),sizeof(qpomi))
+         call TabCacheArray(loc(qpomis),sizeof(qpomis))
+         call TabCacheArray(loc(qloopr),sizeof(qloopr))
+         call TabCacheArray(loc(qlegi),sizeof(qlegi))
+         call TabCacheArray(loc(qfanu),sizeof(qfanu))
+         call TabCacheArray(loc(qfanc),sizeof(qfanc))
+         call TabCacheArray(loc(pdfr),sizeof(pdfr))
+         call TabCacheArray(loc(qpomr),sizeof(qpomr))
+         call TabCacheArray(loc(dhteik),sizeof(dhteik))
+         call TabCacheArray(loc(feikht),sizeof(feikht))
+         call TabCacheArray(loc(ffhtm),sizeof(ffhtm))
+         call TabCacheArray(loc(flhtm),sizeof(flhtm))
+         call TabCacheArray(loc(gsect),sizeof(gsect))
+         call TabCacheArray(loc(fsud),sizeof(fsud))
+         call TabCacheArray(loc(qrt),sizeof(qrt))
+         call TabCacheLoad(icache)
+        endif
+        if(icache.eq.0)then
          if(ifIIIdat.ne.1)then
             open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-III'
      *           ,status='old')
          else                   !used to link with nexus
             if (LEN(fnIIIdat).gt.6.and.
-     *           fnIIIdat(nfnIIIdat-4:nfnIIIdat) .eq. ".lzma") then
+     *           (fnIIIdat(nfnIIIdat-4:nfnIIIdat) .eq. ".lzma".or.
+     *            fnIIIdat(nfnIIIdat-3:nfnIIIdat) .eq. ".zst")) then
                lzmaUse=1
                call LzmaOpenFile(fnIIIdat(1:nfnIIIdat))
             else
@@ -445,6 +472,8 @@ c     *       ,fnIIIdat(1:nfnIIIdat)
      * ,qfanc,pdfr,qpomr,dhteik,feikht,ffhtm,flhtm,gsect,fsud,qrt
           close(1)
         endif
+        if(ifIIIdat.eq.1)call TabCacheSave()
+        endif
       
        if(debug.ge.0)write (moniou,202)
        
@@ -1024,10 +1053,14 @@ c uncut fan-contributions
       enddo
       enddo
               
+c the (icz,ifock) cells are independent, see src/tabcache/TabFork.h
+      call TabForkArray(loc(qfanu),sizeof(qfanu))
+      call TabForkBegin(iwork,nwork)
       do icz=1,3
       do iv=1,11
        vvx=dble(iv-1)/10.d0
       do ifock=1,nfock
+      if(mod(ifock-1+nfock*(icz-1),nwork).eq.iwork)then
        do iy=2,31
         sy=sgap**2*(spmax/sgap**3)**((iy-1)/30.d0)
         rp=(rq(ifock,icz)+alfp*dlog(sy))*4.d0*.0389d0
@@ -1082,9 +1115,11 @@ c uncut fan-contributions
         enddo
         if(nrep.eq.1)goto 10
        enddo
+      endif
       enddo
       enddo
       enddo
+      call TabForkEnd()
 
 c-------------------------------------------------
 c b-dependent pdfs (hp-case)
@@ -1187,8 +1222,11 @@ c cut fan contributions
       enddo
       enddo
      
+      call TabForkArray(loc(qfanc),sizeof(qfanc))
+      call TabForkBegin(iwork,nwork)
       do icz=1,3                                  !hadron class
       do ifock=1,nfock
+      if(mod(ifock-1+nfock*(icz-1),nwork).eq.iwork)then
 c vvx,vvxp,vvxpl - screening corrections from targ. and nuclear proj. fans
       do iv=1,11  
        vvx=dble(iv-1)/10.d0
@@ -1262,8 +1300,10 @@ c vvx,vvxp,vvxpl - screening corrections from targ. and nuclear proj. fans
       enddo
       enddo
       enddo
+      endif
       enddo
       enddo
+      call TabForkEnd()
 
 c-------------------------------------------------
 c b-dependent pdfs
@@ -1695,14 +1735,21 @@ c-----------------------------------------------------------------------------
 c writing cross sections to the file
       if(debug.ge.1)write (moniou,220)
       if(ifIIIdat.ne.1)then
-       open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-III'
+       open(1,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-III.tmp'
      * ,status='unknown')
       else                                              !used to link with nexus
-       open(ifIIIdat,file=fnIIIdat(1:nfnIIIdat),status='unknown')
+       open(ifIIIdat,file=fnIIIdat(1:nfnIIIdat)//'.tmp'
+     * ,status='unknown')
       endif
       write (1,*)csborn,cs0,cstot,evk,qpomi,qpomis,qloopr,qlegi,qfanu
      * ,qfanc,pdfr,qpomr,dhteik,feikht,ffhtm,flhtm,gsect,fsud,qrt
       close(1)
+      if(ifIIIdat.ne.1)then
+       call TabCommit(DATDIR(1:INDEX(DATDIR,' ')-1)//'qgsdat-III'
+     * ,INDEX(DATDIR,' ')+9)
+      else
+       call TabCommit(fnIIIdat,nfnIIIdat)
+      endif
 
 c-----------------------------------------------------------------------------
 c nuclear cross sections
@@ -1753,13 +1800,20 @@ c nuclear cross sections
        enddo
        enddo
        if(ifIIIncs.ne.2)then
-        open(2,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-III'
+        open(2,file=DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-III.tmp'
      *  ,status='unknown')
        else                                                  !ctp
-        open(ifIIIncs,file=fnIIIncs(1:nfnIIIncs),status='unknown')
+        open(ifIIIncs,file=fnIIIncs(1:nfnIIIncs)//'.tmp'
+     *  ,status='unknown')
        endif
        write (2,*)qgsasect
        close(2)
+       if(ifIIIncs.ne.2)then
+        call TabCommit(DATDIR(1:INDEX(DATDIR,' ')-1)//'sectnu-III'
+     *  ,INDEX(DATDIR,' ')+9)
+       else
+        call TabCommit(fnIIIncs,nfnIIIncs)
+       endif
       endif
  
       if(debug.ge.3)write (moniou,218)
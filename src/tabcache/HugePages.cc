@@ -0,0 +1,51 @@
+#include "HugePages.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+
+#include <sys/mman.h>
+
+using namespace std;
+
+
+bool
+HugePages::IsEnabled()
+{
+  static const char* env = getenv("CRMC_HUGEPAGES");
+  static const bool enabled = (env && strcmp(env, "on") == 0);
+  return enabled;
+}
+
+
+size_t
+HugePages::PageSize()
+{
+  static size_t size = 0;
+  if (!size) {
+    ifstream in("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+    if (!(in >> size) || size == 0)
+      size = 2 << 20;
+  }
+  return size;
+}
+
+
+size_t
+HugePages::Advise(void* data, const size_t size)
+{
+#ifdef MADV_HUGEPAGE
+  if (!IsEnabled() || size == 0)
+    return 0;
+  // whole huge pages only come from aligned ranges; outside the mapping
+  // of the common blocks madvise fails (ENOMEM), the rest is advised
+  const uintptr_t pageSize = PageSize();
+  const uintptr_t begin = (uintptr_t)data / pageSize * pageSize;
+  const uintptr_t end = ((uintptr_t)data + size + pageSize - 1) / pageSize * pageSize;
+  madvise((void*)begin, end - begin, MADV_HUGEPAGE);
+  return end - begin;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,36 @@
+#ifndef _include_HugePages_h_
+#define _include_HugePages_h_
+
+#include <cstddef>
+
+/**
+ * Transparent huge pages for the large arrays in common blocks.
+ *
+ * The model tables are interpolated at random positions and the
+ * particle list is spread over many arrays, which with 4 kB pages
+ * costs many TLB misses.  With CRMC_HUGEPAGES=on the arrays are given
+ * madvise(MADV_HUGEPAGE) before they are first written, so the kernel
+ * backs them with huge pages (2 MB on x86_64) where possible:
+ *
+ *   call HugePages(loc(qfanu),sizeof(qfanu))
+ *
+ * The advised range is extended to whole huge pages, the variables
+ * next to an array in the common block get huge pages as well.  All
+ * arrays registered with TabCacheArray are advised, and the cache then
+ * copies them instead of mapping them from the cache file (file pages
+ * are not huge).  Needs /sys/kernel/mm/transparent_hugepage/enabled to
+ * be "madvise" or "always".
+ */
+class HugePages {
+
+ public:
+  static bool IsEnabled();
+  /** Advises data for huge pages if enabled, returns the advised bytes */
+  static size_t Advise(void* data, const size_t size);
+
+ private:
+  static size_t PageSize();
+};
+
+
+#endif
@@ -0,0 +1,8 @@
+#include "HugePages.interface.h"
+#include "HugePages.h"
+
+extern "C" {
+  void hugepages_(const intptr_t& address, const size_t& size) {
+    HugePages::Advise(reinterpret_cast<void*>(address), size);
+  }
+}
@@ -0,0 +1,11 @@
+#ifndef _include_HugePages_interface_h_
+#define _include_HugePages_interface_h_
+
+#include <cstddef>
+#include <stdint.h>
+
+// arrays are passed as Fortran loc(), sizes as sizeof
+extern "C" { void hugepages_(const intptr_t& address, const size_t& size); }
+
+
+#endif
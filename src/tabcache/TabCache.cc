@@ -0,0 +1,348 @@
+#include "TabCache.h"
+#include "HugePages.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+  const char kMagic[8] = { 'C', 'R', 'M', 'C', 'T', 'A', 'B', '\n' };
+
+  /** mkdir -p, false on errors */
+  bool
+  MakeDirectory(const string& dir)
+  {
+    for (size_t pos = 1; pos <= dir.size(); ++pos) {
+      if (pos < dir.size() && dir[pos] != '/')
+        continue;
+      const string sub = dir.substr(0, pos);
+      if (mkdir(sub.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+    }
+    return true;
+  }
+
+  bool
+  WriteAll(const int fd, const void* data, size_t size)
+  {
+    const char* p = (const char*)data;
+    while (size > 0) {
+      const ssize_t n = write(fd, p, size);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+}
+
+
+TabCache&
+TabCache::Get()
+{
+  static TabCache cache;
+  return cache;
+}
+
+
+TabCache::TabCache() :
+  fPageSize(sysconf(_SC_PAGESIZE)),
+  fShare(true),
+  fVerify(true)
+{
+  const char* dir = getenv("CRMC_TABCACHE");
+  if (dir && *dir) {
+    if (strcmp(dir, "off") != 0 && strcmp(dir, "0") != 0)
+      fDirectory = dir;
+  }
+  else if (getenv("HOME"))
+    fDirectory = string(getenv("HOME")) + "/.cache/crmc";
+  const char* share = getenv("CRMC_TABCACHE_SHARE");
+  if (share && (strcmp(share, "off") == 0 || strcmp(share, "0") == 0))
+    fShare = false;
+  // the mapped file pages would replace the huge pages
+  if (HugePages::IsEnabled())
+    fShare = false;
+  const char* verify = getenv("CRMC_TABCACHE_VERIFY");
+  if (verify && (strcmp(verify, "off") == 0 || strcmp(verify, "0") == 0))
+    fVerify = false;
+}
+
+
+void
+TabCache::Begin(const string& fileName, const string& tag)
+{
+  fFileName = fileName;
+  fTag = tag;
+  fUserKey.clear();
+  fArrays.clear();
+  fKey.clear();
+  fCacheName.clear();
+  fBegin = chrono::steady_clock::now();
+}
+
+
+void
+TabCache::AddRecord(const bool fromCache)
+{
+  const chrono::duration<double> seconds = chrono::steady_clock::now() - fBegin;
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  Record r = { fFileName, seconds.count(), usage.ru_maxrss / 1024., fromCache };
+  fRecords.push_back(r);
+}
+
+
+void
+TabCache::Key(const void* data, const size_t size)
+{
+  fUserKey.append((const char*)data, size);
+}
+
+
+void
+TabCache::Array(void* data, const size_t size)
+{
+  HugePages::Advise(data, size);
+  Entry e = { data, size };
+  fArrays.push_back(e);
+}
+
+
+uint64_t
+TabCache::Checksum(const void* data, const size_t size, uint64_t hash)
+{
+  const unsigned char* p = (const unsigned char*)data;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t w;
+    memcpy(&w, p + i, 8);
+    hash = (hash ^ w) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+  }
+  for (; i < size; ++i)
+    hash = (hash ^ p[i]) * 0x100000001B3ULL;
+  return hash;
+}
+
+
+bool
+TabCache::MakeKey()
+{
+  if (fDirectory.empty() || fArrays.empty())
+    return false;
+
+  // the text table is identified by name, size and modification time
+  struct stat st;
+  if (stat(fFileName.c_str(), &st) != 0)
+    return false;
+  const size_t slash = fFileName.rfind('/');
+  const string baseName = (slash == string::npos ? fFileName : fFileName.substr(slash + 1));
+
+  ostringstream key;
+  key << "version=" << kVersion << " tag=" << fTag << " table=" << baseName
+      << " size=" << st.st_size << " mtime=" << st.st_mtime << " page=" << fPageSize
+      << " arrays=";
+  for (size_t i = 0; i < fArrays.size(); ++i)
+    key << (i ? "," : "") << fArrays[i].fSize << "@" << (uintptr_t)fArrays[i].fData % fPageSize;
+  key << " key=" << hex << Checksum(fUserKey.data(), fUserKey.size(), 0);
+  fKey = key.str();
+
+  ostringstream name;
+  name << fDirectory << "/" << baseName << "." << hex << setw(16) << setfill('0')
+       << Checksum(fKey.data(), fKey.size(), 0) << ".tab";
+  fCacheName = name.str();
+  return true;
+}
+
+
+bool
+TabCache::Load()
+{
+  if (!MakeKey())
+    return false;
+
+  const int fd = open(fCacheName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void* map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t)fPageSize)
+    map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  const size_t fileSize = st.st_size;
+  if (fVerify)
+    madvise(map, fileSize, MADV_SEQUENTIAL);
+
+  // header: magic, payload offset, key, payload size, checksum
+  const char* p = (const char*)map;
+  uint64_t offset = 0;
+  uint64_t keySize = 0;
+  uint64_t payloadSize = 0;
+  uint64_t checksum = 0;
+  memcpy(&offset, p + 8, 8);
+  memcpy(&keySize, p + 16, 8);
+  bool ok = (memcmp(p, kMagic, 8) == 0 && 24 + keySize + 16 <= offset && offset <= fileSize
+             && string(p + 24, keySize) == fKey);
+  vector<uint64_t> offsets;
+  if (ok) {
+    memcpy(&payloadSize, p + 24 + keySize, 8);
+    memcpy(&checksum, p + 32 + keySize, 8);
+    ok = (offset + payloadSize == fileSize && Layout(offset, offsets) == fileSize);
+  }
+
+  // verified before anything is copied into the arrays or mapped over them
+  if (ok && fVerify) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < fArrays.size(); ++i)
+      sum = Checksum(p + offsets[i], fArrays[i].fSize, sum);
+    if (sum != checksum) {
+      cout << "TabCache: " << fCacheName << " is corrupt, ignored" << endl;
+      ok = false;
+    }
+  }
+  size_t shared = 0;
+  for (size_t i = 0; ok && i < fArrays.size(); ++i)
+    shared += MapArray(fArrays[i], fd, p, offsets[i]);
+  if (ok) {
+    cout << "read from " << fCacheName << " (" << (shared >> 20) << " MB shared) ..." << endl;
+    AddRecord(true);
+  }
+  munmap(map, fileSize);
+  close(fd);
+  return ok;
+}
+
+
+size_t
+TabCache::MapArray(const Entry& array, const int fd, const char* file, const uint64_t offset)
+{
+  // the pages inside the array are mapped copy-on-write from the cache
+  // file: all processes reading the same cache share one physical copy
+  // in the page cache, as long as they do not write to the array
+  char* const begin = (char*)array.fData;
+  char* const end = begin + array.fSize;
+  char* const first = (char*)(((uintptr_t)begin + fPageSize - 1) / fPageSize * fPageSize);
+  char* const last = (char*)((uintptr_t)end / fPageSize * fPageSize);
+  if (!fShare || last <= first) {
+    memcpy(begin, file + offset, array.fSize);
+    return 0;
+  }
+
+  // the partial pages at both ends hold other variables of the common block
+  memcpy(begin, file + offset, first - begin);
+  memcpy(last, file + offset + (last - begin), end - last);
+  const size_t size = last - first;
+  const off_t pageOffset = offset + (first - begin);
+  if (mmap(first, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, pageOffset)
+      != MAP_FAILED)
+    return size;
+
+  // a failed MAP_FIXED may have removed the old pages
+  if (mmap(first, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0)
+      == MAP_FAILED) {
+    cerr << "TabCache: cannot map " << fCacheName << endl;
+    exit(1);
+  }
+  memcpy(first, file + pageOffset, size);
+  return 0;
+}
+
+
+uint64_t
+TabCache::Layout(const uint64_t begin, vector<uint64_t>& offsets)
+  const
+{
+  // every array starts at the same offset within a page as in memory
+  offsets.clear();
+  uint64_t pos = begin;
+  for (size_t i = 0; i < fArrays.size(); ++i) {
+    const uint64_t inPage = (uintptr_t)fArrays[i].fData % fPageSize;
+    pos += (inPage + fPageSize - pos % fPageSize) % fPageSize;
+    offsets.push_back(pos);
+    pos += fArrays[i].fSize;
+  }
+  return pos;
+}
+
+
+void
+TabCache::Commit(const string& fileName)
+{
+  const string tmpName = fileName + ".tmp";
+  if (rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    cerr << "TabCache: cannot rename " << tmpName << " to " << fileName << ": "
+         << strerror(errno) << endl;
+    exit(1);
+  }
+}
+
+
+void
+TabCache::Save()
+{
+  AddRecord(false);
+  if (!MakeKey() || !MakeDirectory(fDirectory))
+    return;
+
+  const uint64_t keySize = fKey.size();
+  const uint64_t offset = (24 + keySize + 16 + fPageSize - 1) / fPageSize * fPageSize;
+  vector<uint64_t> offsets;
+  const uint64_t payloadSize = Layout(offset, offsets) - offset;
+  uint64_t checksum = 0;
+  for (size_t i = 0; i < fArrays.size(); ++i)
+    checksum = Checksum(fArrays[i].fData, fArrays[i].fSize, checksum);
+
+  string header(offset, '\0');
+  memcpy(&header[0], kMagic, 8);
+  memcpy(&header[8], &offset, 8);
+  memcpy(&header[16], &keySize, 8);
+  memcpy(&header[24], fKey.data(), keySize);
+  memcpy(&header[24 + keySize], &payloadSize, 8);
+  memcpy(&header[32 + keySize], &checksum, 8);
+
+  // other jobs may write the same cache at the same time
+  ostringstream tmpName;
+  tmpName << fCacheName << ".tmp" << getpid();
+  const int fd = open(tmpName.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    cout << "TabCache: cannot write " << tmpName.str() << endl;
+    return;
+  }
+  bool ok = WriteAll(fd, header.data(), header.size());
+  uint64_t pos = offset;
+  const string padding(fPageSize, '\0');
+  for (size_t i = 0; ok && i < fArrays.size(); ++i) {
+    ok = WriteAll(fd, padding.data(), offsets[i] - pos)
+         && WriteAll(fd, fArrays[i].fData, fArrays[i].fSize);
+    pos = offsets[i] + fArrays[i].fSize;
+  }
+  ok = (close(fd) == 0) && ok;
+  if (ok && rename(tmpName.str().c_str(), fCacheName.c_str()) == 0)
+    cout << "TabCache: written " << fCacheName << endl;
+  else {
+    cout << "TabCache: cannot write " << fCacheName << endl;
+    unlink(tmpName.str().c_str());
+  }
+}
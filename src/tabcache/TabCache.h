@@ -0,0 +1,112 @@
+#ifndef _include_TabCache_h_
+#define _include_TabCache_h_
+
+#include <chrono>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Binary cache of the model tables.
+ *
+ * Parsing the text tables (EPOS epos.ini*, QGSJET qgsdat and sectnu)
+ * takes most of the start-up time.  The Fortran readers register the
+ * arrays a table fills, in their order, and try the cache first:
+ *
+ *   call TabCacheBegin(fnie,nfnie,'iniev',5)
+ *   call TabCacheArray(loc(evk),sizeof(evk))
+ *   call TabCacheLoad(icache)
+ *   if(icache.eq.0)then
+ *     ... read the text table as before ...
+ *     call TabCacheSave()
+ *   endif
+ *
+ * The cache file holds the raw bytes of the arrays behind a header with
+ * the key: format version, tag, size and modification time of the text
+ * table, the array sizes (so changed compile-time dimensions are
+ * detected) and the values given to TabCacheKey.  The payload has a
+ * checksum, it is written to a temporary file and renamed, so parallel
+ * jobs never see half-written caches.
+ *
+ * Every array is stored at the same offset within a page as it has in
+ * memory, so the whole pages of an array are mapped copy-on-write from
+ * the cache file over the common block instead of being copied.  All
+ * jobs of a node that read the same cache then share one physical copy
+ * of the tables in the page cache; a job writing to an array gets its
+ * own copy of the written pages only.  The checksum is verified before
+ * the arrays are mapped, which reads the whole cache file once (from the
+ * page cache if another job has read it); CRMC_TABCACHE_VERIFY=off skips
+ * it, half-written caches are excluded by the rename anyway.  Only
+ * without the check are the pages read where the model touches them.
+ *
+ * The cache directory is $CRMC_TABCACHE, else $HOME/.cache/crmc;
+ * CRMC_TABCACHE=off disables the cache, CRMC_TABCACHE_SHARE=off the
+ * mapping (the arrays are copied then).  With CRMC_HUGEPAGES=on the
+ * arrays are put in huge pages (see HugePages.h) and copied as well.
+ */
+class TabCache {
+
+ public:
+  /** Read time of a table, for the start-up profile (crmc --profile-startup) */
+  struct Record {
+    std::string fFileName;
+    double fSeconds;
+    double fPeakRSS; // MB
+    bool fFromCache;
+  };
+
+  static TabCache& Get();
+
+  /** Start the array list of the text table fileName */
+  void Begin(const std::string& fileName, const std::string& tag);
+  /** Run setting the table content depends on, not stored as array */
+  void Key(const void* data, const size_t size);
+  /** Next array filled from the table */
+  void Array(void* data, const size_t size);
+  /** Fill all arrays from a valid cache, false if there is none */
+  bool Load();
+  /** Write the arrays, after they were read from the text table */
+  void Save();
+  /** Replaces fileName by fileName.tmp, so that no job reads half-written tables */
+  static void Commit(const std::string& fileName);
+
+  const std::vector<Record>& GetRecords() const { return fRecords; }
+
+  static const uint64_t kVersion = 2;
+
+ private:
+  TabCache();
+
+  struct Entry {
+    void* fData;
+    size_t fSize;
+  };
+
+  /** Builds fKey and fCacheName, false if caching is not possible */
+  bool MakeKey();
+  /** File offsets of the arrays in a payload starting at begin, returns its end */
+  uint64_t Layout(const uint64_t begin, std::vector<uint64_t>& offsets) const;
+  /** Maps or copies an array from the cache, returns the mapped bytes */
+  size_t MapArray(const Entry& array, const int fd, const char* file, const uint64_t offset);
+  static uint64_t Checksum(const void* data, const size_t size, uint64_t hash);
+  void AddRecord(const bool fromCache);
+
+  const size_t fPageSize;
+  bool fShare;
+  bool fVerify;
+  std::string fDirectory; // empty if disabled
+  std::string fFileName;
+  std::string fTag;
+  std::string fUserKey;
+  std::vector<Entry> fArrays;
+
+  std::string fKey;
+  std::string fCacheName;
+
+  std::chrono::steady_clock::time_point fBegin;
+  std::vector<Record> fRecords;
+};
+
+
+#endif
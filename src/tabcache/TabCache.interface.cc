@@ -0,0 +1,58 @@
+#include "TabCache.interface.h"
+#include "TabCache.h"
+
+#include <cstring>
+#include <string>
+using namespace std;
+
+extern "C" {
+  void tabcachebegin_(const char* name, const int& nName, const char* tag, const int& nTag) {
+    TabCache::Get().Begin(string(name, nName), string(tag, nTag));
+  }
+}
+
+extern "C" {
+  void tabcachekey_(const intptr_t& address, const size_t& size) {
+    TabCache::Get().Key(reinterpret_cast<const void*>(address), size);
+  }
+}
+
+extern "C" {
+  void tabcachearray_(const intptr_t& address, const size_t& size) {
+    TabCache::Get().Array(reinterpret_cast<void*>(address), size);
+  }
+}
+
+extern "C" {
+  void tabcacheload_(int& found) {
+    found = TabCache::Get().Load() ? 1 : 0;
+  }
+}
+
+extern "C" {
+  void tabcachesave_() {
+    TabCache::Get().Save();
+  }
+}
+
+extern "C" {
+  int tabcacherecord_(const int& i, char* name, const int& nName, double& seconds,
+                      double& peakRSS, int& fromCache) {
+    const vector<TabCache::Record>& records = TabCache::Get().GetRecords();
+    if (i < 0 || i >= int(records.size()) || nName <= 0)
+      return 0;
+    const TabCache::Record& r = records[i];
+    strncpy(name, r.fFileName.c_str(), nName - 1);
+    name[nName - 1] = '\0';
+    seconds = r.fSeconds;
+    peakRSS = r.fPeakRSS;
+    fromCache = r.fFromCache;
+    return 1;
+  }
+}
+
+extern "C" {
+  void tabcommit_(const char* name, const int& nName) {
+    TabCache::Commit(string(name, nName));
+  }
+}
@@ -0,0 +1,21 @@
+#ifndef _include_TabCache_interface_h_
+#define _include_TabCache_interface_h_
+
+#include <cstddef>
+#include <stdint.h>
+
+// the names and tags are passed with their length; the arrays as Fortran
+// loc(), so that all calls have the same argument types, sizes as sizeof
+extern "C" { void tabcachebegin_(const char* name, const int& nName, const char* tag, const int& nTag); }
+extern "C" { void tabcachekey_(const intptr_t& address, const size_t& size); }
+extern "C" { void tabcachearray_(const intptr_t& address, const size_t& size); }
+extern "C" { void tabcacheload_(int& found); }
+extern "C" { void tabcachesave_(); }
+// i-th table read so far, 0 if there is none (for CRMCinterface::crmc_tables)
+extern "C" { int tabcacherecord_(const int& i, char* name, const int& nName, double& seconds,
+                                 double& peakRSS, int& fromCache); }
+// renames <name>.tmp to name, after a table was written
+extern "C" { void tabcommit_(const char* name, const int& nName); }
+
+
+#endif
@@ -0,0 +1,207 @@
+#include "TabFork.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+namespace {
+
+  // change record: array index, byte offset and number of bytes, followed by the bytes
+  struct Record {
+    uint64_t fIndex;
+    uint64_t fOffset;
+    uint64_t fSize;
+  };
+  const uint64_t kEnd = ~uint64_t(0);
+
+  bool
+  WriteAll(const int fd, const void* data, size_t size)
+  {
+    const char* p = (const char*)data;
+    while (size > 0) {
+      const ssize_t n = write(fd, p, size);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  bool
+  ReadAll(const int fd, void* data, size_t size)
+  {
+    char* p = (char*)data;
+    while (size > 0) {
+      const ssize_t n = read(fd, p, size);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+}
+
+
+TabFork&
+TabFork::Get()
+{
+  static TabFork fork;
+  return fork;
+}
+
+
+TabFork::TabFork() :
+  fNWorkers(1),
+  fWorker(0)
+{
+  const char* jobs = getenv("CRMC_TABLE_JOBS");
+  if (jobs && atoi(jobs) > 1)
+    fNWorkers = atoi(jobs);
+}
+
+
+void
+TabFork::Array(void* data, const size_t size)
+{
+  Entry e = { data, size };
+  fArrays.push_back(e);
+}
+
+
+int
+TabFork::Begin()
+{
+  fWorker = 0;
+  if (fNWorkers <= 1)
+    return 0;
+
+  // the workers send the bytes that differ from the state before the loop
+  fSnapshot.clear();
+  for (size_t i = 0; i < fArrays.size(); ++i)
+    fSnapshot.push_back(string((const char*)fArrays[i].fData, fArrays[i].fSize));
+
+  fflush(0);
+  cout << flush;
+  for (int w = 1; w < fNWorkers; ++w) {
+    int fd[2];
+    if (pipe(fd) != 0) {
+      cerr << "TabFork: cannot create pipe: " << strerror(errno) << endl;
+      exit(1);
+    }
+    const pid_t pid = fork();
+    if (pid < 0) {
+      cerr << "TabFork: cannot start worker: " << strerror(errno) << endl;
+      exit(1);
+    }
+    if (pid == 0) {
+      close(fd[0]);
+      for (size_t i = 0; i < fPipes.size(); ++i)
+        close(fPipes[i]);
+      fPipes.assign(1, fd[1]);
+      fPids.clear();
+      fWorker = w;
+      return w;
+    }
+    close(fd[1]);
+    fPipes.push_back(fd[0]);
+    fPids.push_back(pid);
+  }
+  return 0;
+}
+
+
+void
+TabFork::End()
+{
+  if (fNWorkers <= 1) {
+    fArrays.clear();
+    return;
+  }
+
+  if (fWorker != 0) {
+    // _exit: the buffers (also of the Fortran units) belong to the main process
+    SendChanges(fPipes[0]);
+    _exit(0);
+  }
+
+  bool ok = true;
+  for (size_t w = 0; w < fPids.size(); ++w) {
+    ok = ReceiveChanges(fPipes[w]) && ok;
+    close(fPipes[w]);
+    int status = 0;
+    while (waitpid(fPids[w], &status, 0) < 0 && errno == EINTR)
+      ;
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  if (!ok) {
+    cerr << "TabFork: a table worker failed, the table is not complete" << endl;
+    exit(1);
+  }
+  fArrays.clear();
+  fSnapshot.clear();
+  fPids.clear();
+  fPipes.clear();
+}
+
+
+void
+TabFork::SendChanges(const int fd)
+  const
+{
+  bool ok = true;
+  for (size_t i = 0; ok && i < fArrays.size(); ++i) {
+    const char* data = (const char*)fArrays[i].fData;
+    const char* old = fSnapshot[i].data();
+    const size_t size = fArrays[i].fSize;
+    size_t pos = 0;
+    while (ok && pos < size) {
+      while (pos + 64 <= size && memcmp(data + pos, old + pos, 64) == 0)
+        pos += 64;
+      while (pos < size && data[pos] == old[pos])
+        ++pos;
+      // exactly the changed bytes, the others may be changed by other workers
+      const size_t begin = pos;
+      while (pos < size && data[pos] != old[pos])
+        ++pos;
+      if (pos > begin) {
+        const Record r = { i, begin, pos - begin };
+        ok = WriteAll(fd, &r, sizeof(r)) && WriteAll(fd, data + begin, pos - begin);
+      }
+    }
+  }
+  const Record end = { kEnd, 0, 0 };
+  if (!ok || !WriteAll(fd, &end, sizeof(end)))
+    _exit(1);
+}
+
+
+bool
+TabFork::ReceiveChanges(const int fd)
+{
+  Record r;
+  while (ReadAll(fd, &r, sizeof(r))) {
+    if (r.fIndex == kEnd)
+      return true;
+    if (r.fIndex >= fArrays.size() || r.fOffset + r.fSize > fArrays[r.fIndex].fSize)
+      return false;
+    if (!ReadAll(fd, (char*)fArrays[r.fIndex].fData + r.fOffset, r.fSize))
+      return false;
+  }
+  return false; // the worker stopped before the end of the loop
+}
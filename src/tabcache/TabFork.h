@@ -0,0 +1,64 @@
+#ifndef _include_TabFork_h_
+#define _include_TabFork_h_
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * Parallel computation of independent table cells in worker processes.
+ *
+ * The table code keeps its state in common blocks and is not thread
+ * safe, so the cells of a table loop are shared among forked copies of
+ * the process.  Every worker computes its cells in the original order
+ * and sends back the bytes it changed in the registered arrays:
+ *
+ *   call TabForkArray(loc(qfanu),sizeof(qfanu))
+ *   call TabForkBegin(iwork,nwork)
+ *   do icz=1,3
+ *    if(mod(icz-1,nwork).eq.iwork)then
+ *     ... fill qfanu(...,icz,...) ...
+ *    endif
+ *   enddo
+ *   call TabForkEnd()
+ *
+ * Cells must only read their own values and the arrays computed before
+ * the loop, then the result is the same as in one process.  The number
+ * of processes is $CRMC_TABLE_JOBS (default 1: no workers are started).
+ */
+class TabFork {
+
+ public:
+  static TabFork& Get();
+
+  /** Next array filled by the loop */
+  void Array(void* data, const size_t size);
+  /** Starts the workers, returns the index of this process (0 is the main one) */
+  int Begin();
+  /** Collects the arrays in the main process; workers do not return */
+  void End();
+
+  int GetNWorkers() const { return fNWorkers; }
+
+ private:
+  TabFork();
+
+  struct Entry {
+    void* fData;
+    size_t fSize;
+  };
+
+  void SendChanges(const int fd) const;
+  bool ReceiveChanges(const int fd);
+
+  int fNWorkers;
+  int fWorker;
+  std::vector<Entry> fArrays;
+  std::vector<std::string> fSnapshot;
+  std::vector<pid_t> fPids;
+  std::vector<int> fPipes;
+};
+
+
+#endif
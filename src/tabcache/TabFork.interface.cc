@@ -0,0 +1,21 @@
+#include "TabFork.interface.h"
+#include "TabFork.h"
+
+extern "C" {
+  void tabforkarray_(const intptr_t& address, const size_t& size) {
+    TabFork::Get().Array(reinterpret_cast<void*>(address), size);
+  }
+}
+
+extern "C" {
+  void tabforkbegin_(int& iWork, int& nWork) {
+    iWork = TabFork::Get().Begin();
+    nWork = TabFork::Get().GetNWorkers();
+  }
+}
+
+extern "C" {
+  void tabforkend_() {
+    TabFork::Get().End();
+  }
+}
@@ -0,0 +1,13 @@
+#ifndef _include_TabFork_interface_h_
+#define _include_TabFork_interface_h_
+
+#include <cstddef>
+#include <stdint.h>
+
+// arrays are passed as Fortran loc(), sizes as sizeof
+extern "C" { void tabforkarray_(const intptr_t& address, const size_t& size); }
+extern "C" { void tabforkbegin_(int& iWork, int& nWork); }
+extern "C" { void tabforkend_(); }
+
+
+#endif